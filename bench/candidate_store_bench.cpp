@@ -0,0 +1,159 @@
+// Cohort scoring throughput: one LASUScreeningAggregator object per
+// candidate against the columnar CandidateStore with each kernel this CPU
+// runs. Every kernel's output is checked against the aggregators first.
+//
+//   lasu_store_bench [candidates]
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "candidate_store.h"
+
+using namespace std;
+
+namespace
+{
+    struct Cohort
+    {
+        vector<LASUScreeningAggregator> calculators;
+        vector<int> jamb_score;
+        vector<int> course_category;
+    };
+
+    // Random candidates over every faculty, including unknown categories,
+    // missing required grades, out-of-range JAMB scores and long optional
+    // lists that overflow the store's slots
+    Cohort makeCohort(size_t count)
+    {
+        static const char *const grades[] = {"A1", "B2", "B3", "C4", "C5", "C6", "D7", "E8", "F9"};
+        static const char *const extras[] = {"Further Mathematics", "Agricultural Science", "Civic Education",
+                                             "Yoruba", "Computer Studies", "Technical Drawing"};
+        mt19937 random(20240501);
+        auto pick = [&random](int limit)
+        { return static_cast<int>(random() % static_cast<unsigned>(limit)); };
+
+        Cohort cohort;
+        cohort.calculators.resize(count);
+        cohort.jamb_score.resize(count);
+        cohort.course_category.resize(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            LASUScreeningAggregator &calculator = cohort.calculators[i];
+            int category = pick(14) - 1;
+            int jamb = pick(20) == 0 ? 450 : pick(401);
+            cohort.jamb_score[i] = jamb;
+            cohort.course_category[i] = category;
+            calculator.setJambScore(jamb);
+            calculator.setRequiredSubjects(category);
+
+            for (int s = 0; s < static_cast<int>(Subject::Count); ++s)
+            {
+                if (pick(8) != 0)
+                {
+                    calculator.addGrade(subjectName(static_cast<Subject>(s)), grades[pick(9)]);
+                }
+            }
+            int optional = pick(8);
+            for (int s = 0; s < optional; ++s)
+            {
+                calculator.addOptionalSubject(pick(2) ? extras[pick(6)] : subject_names[pick(10)], grades[pick(9)]);
+            }
+        }
+        return cohort;
+    }
+
+    bool sameResults(const Cohort &cohort, const CandidateStore &store)
+    {
+        for (size_t i = 0; i < store.size(); ++i)
+        {
+            const LASUScreeningAggregator &expected = cohort.calculators[i];
+            bool same = store.waec_total[i] == expected.getTotalScore() &&
+                        store.waec_max_points[i] == expected.getMaxPoints() &&
+                        store.waec_percentage[i] == expected.getPercentage() &&
+                        store.final_score[i] == expected.getFinalScreeningScore() &&
+                        admissionStatusText(static_cast<AdmissionStatus>(store.admission[i])) == expected.getAdmissionStatus() &&
+                        statusClassName(static_cast<StatusClass>(store.status[i])) == expected.getStatusClass();
+
+            const CandidateGrades::Entry *best = expected.getGrades().bestOptional();
+            bool counted = expected.getFacultyPolicy().counts_best_optional && best;
+            if (counted != (store.best_optional[i] != CandidateStore::no_optional))
+                same = false;
+            else if (counted && store.optional_grade[store.best_optional[i]][i] != static_cast<uint8_t>(best->grade))
+                same = false;
+
+            if (!same)
+            {
+                cerr << scoringKernelName(store.scoringKernel()) << " kernel disagrees at candidate " << i
+                     << ": " << static_cast<int>(store.waec_total[i]) << "/" << static_cast<int>(store.waec_max_points[i])
+                     << " " << setprecision(17) << store.final_score[i] << " vs " << expected.getTotalScore() << "/"
+                     << expected.getMaxPoints() << " " << expected.getFinalScreeningScore() << endl;
+                return false;
+            }
+        }
+        return true;
+    }
+
+    template <typename Work>
+    double bestOf(int runs, Work work)
+    {
+        double best = 1e9;
+        for (int run = 0; run < runs; ++run)
+        {
+            auto start = chrono::steady_clock::now();
+            work();
+            best = min(best, chrono::duration<double>(chrono::steady_clock::now() - start).count());
+        }
+        return best;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    size_t count = argc > 1 ? strtoul(argv[1], nullptr, 10) : 1000000;
+    Cohort cohort = makeCohort(count);
+    ScreeningTable::global();
+
+    cout << count << " candidates, best of 5 runs\n\n";
+    cout << left << setw(14) << "path" << right << setw(12) << "ms" << setw(16) << "candidates/s" << "\n";
+    auto report = [count](const char *path, double seconds)
+    {
+        cout << left << setw(14) << path << right << fixed << setprecision(2) << setw(12) << seconds * 1000
+             << setprecision(0) << setw(16) << count / seconds << "\n";
+    };
+
+    report("objects", bestOf(5, [&cohort]
+                             {
+                                 for (LASUScreeningAggregator &calculator : cohort.calculators)
+                                     calculator.calculateScreeningResults(); }));
+
+    for (ScoringKernel kernel : {ScoringKernel::Scalar, ScoringKernel::Avx2, ScoringKernel::Avx512})
+    {
+        if (!scoringKernelSupported(kernel))
+        {
+            cout << left << setw(14) << scoringKernelName(kernel) << right << setw(12) << "unsupported" << "\n";
+            continue;
+        }
+
+        CandidateStore store(kernel);
+        store.reserve(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            const LASUScreeningAggregator &calculator = cohort.calculators[i];
+            store.add(cohort.jamb_score[i], cohort.course_category[i], calculator.getGrades());
+        }
+
+        store.score();
+        if (!sameResults(cohort, store))
+            return 1;
+        report(scoringKernelName(kernel), bestOf(5, [&store]
+                                                 { store.score(); }));
+    }
+
+    cout << "\nSelected at runtime: " << scoringKernelName(bestScoringKernel()) << "\n";
+    return 0;
+}
@@ -0,0 +1,347 @@
+// End-to-end cost of POST /api/calculate on each networking backend:
+// latency percentiles from a closed-loop keep-alive client, and network
+// syscalls per request as counted by the server itself (/api/stats).
+//
+//   lasu_http_bench --server PATH [--port N] [--connections N] [--requests N]
+//       starts PATH once per backend (epoll, then io_uring) and compares them
+//   lasu_http_bench [--port N] [--connections N] [--requests N]
+//       measures whatever server is already listening on the port
+//
+// Linux only, like the backends it measures.
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <signal.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace std;
+
+namespace
+{
+    const string request_body =
+        R"({"courseCategory":5,"jambScore":300,"requiredSubjects":{"Mathematics":"A1","English_Language":"B2","Physics":"B3","Chemistry":"C4","Biology":"A1"},"optionalSubjects":[]})";
+
+    const string request_text =
+        "POST /api/calculate HTTP/1.1\r\nHost: bench\r\nContent-Type: application/json\r\n"
+        "Content-Length: " + to_string(request_body.size()) + "\r\n\r\n" + request_body;
+
+    struct Client
+    {
+        int fd = -1;
+        string input;
+        chrono::steady_clock::time_point sent_at;
+    };
+
+    struct ServerCounters
+    {
+        string backend = "?";
+        uint64_t requests = 0;
+        uint64_t syscalls = 0;
+        uint64_t wakeups = 0;
+    };
+
+    int connectTo(int port)
+    {
+        int fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_port = htons(static_cast<uint16_t>(port));
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        if (connect(fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) == -1)
+        {
+            close(fd);
+            return -1;
+        }
+        int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        return fd;
+    }
+
+    bool sendAll(int fd, const string &data)
+    {
+        size_t sent = 0;
+        while (sent < data.size())
+        {
+            ssize_t n = send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+            if (n <= 0)
+                return false;
+            sent += static_cast<size_t>(n);
+        }
+        return true;
+    }
+
+    string lowercase(string text)
+    {
+        transform(text.begin(), text.end(), text.begin(), [](unsigned char c)
+                  { return static_cast<char>(tolower(c)); });
+        return text;
+    }
+
+    // Length of the first complete response in `input`, 0 if it is not all
+    // there yet; `close` reports whether the server is ending the connection
+    size_t completeResponse(const string &input, bool &close)
+    {
+        size_t header_end = input.find("\r\n\r\n");
+        if (header_end == string::npos)
+            return 0;
+
+        string head = lowercase(input.substr(0, header_end));
+        size_t length_at = head.find("content-length:");
+        size_t body_length = length_at == string::npos ? 0 : strtoul(head.c_str() + length_at + 15, nullptr, 10);
+        close = head.find("connection: close") != string::npos;
+
+        size_t total = header_end + 4 + body_length;
+        return input.size() >= total ? total : 0;
+    }
+
+    uint64_t jsonNumber(const string &json, const string &key)
+    {
+        size_t at = json.find("\"" + key + "\":");
+        return at == string::npos ? 0 : strtoull(json.c_str() + at + key.size() + 3, nullptr, 10);
+    }
+
+    bool fetchCounters(int port, ServerCounters &counters)
+    {
+        int fd = connectTo(port);
+        if (fd == -1)
+            return false;
+        sendAll(fd, "GET /api/stats HTTP/1.1\r\nHost: bench\r\nConnection: close\r\n\r\n");
+
+        string response;
+        char buffer[4096];
+        ssize_t n;
+        while ((n = recv(fd, buffer, sizeof(buffer), 0)) > 0)
+            response.append(buffer, static_cast<size_t>(n));
+        close(fd);
+
+        size_t backend_at = response.find("\"backend\": \"");
+        if (backend_at != string::npos)
+        {
+            size_t start = backend_at + 12;
+            counters.backend = response.substr(start, response.find('"', start) - start);
+        }
+        counters.requests = jsonNumber(response, "requestsServed");
+        counters.syscalls = jsonNumber(response, "networkSyscalls");
+        counters.wakeups = jsonNumber(response, "workerWakeups");
+        return response.find("200 OK") != string::npos;
+    }
+
+    // Closed loop: every connection keeps exactly one request outstanding.
+    // Returns per-request latencies in microseconds, empty on failure.
+    vector<double> runLoad(int port, int connections, int requests)
+    {
+        int epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+        vector<Client> clients(static_cast<size_t>(connections));
+        vector<double> latencies;
+        latencies.reserve(static_cast<size_t>(requests));
+        int started = 0;
+
+        auto issue = [&](Client &client) -> bool
+        {
+            if (client.fd == -1)
+            {
+                client.fd = connectTo(port);
+                if (client.fd == -1)
+                    return false;
+                epoll_event event{};
+                event.events = EPOLLIN;
+                event.data.ptr = &client;
+                epoll_ctl(epoll_fd, EPOLL_CTL_ADD, client.fd, &event);
+            }
+            ++started;
+            client.sent_at = chrono::steady_clock::now();
+            return sendAll(client.fd, request_text);
+        };
+
+        for (Client &client : clients)
+        {
+            if (started < requests && !issue(client))
+            {
+                cerr << "Cannot connect to port " << port << endl;
+                return {};
+            }
+        }
+
+        epoll_event events[256];
+        while (latencies.size() < static_cast<size_t>(requests))
+        {
+            int ready = epoll_wait(epoll_fd, events, 256, 5000);
+            if (ready <= 0)
+            {
+                cerr << "Server stopped answering" << endl;
+                return {};
+            }
+
+            for (int i = 0; i < ready; ++i)
+            {
+                Client &client = *static_cast<Client *>(events[i].data.ptr);
+                char buffer[16384];
+                ssize_t n = recv(client.fd, buffer, sizeof(buffer), 0);
+                if (n <= 0)
+                {
+                    cerr << "Connection dropped mid-request" << endl;
+                    return {};
+                }
+                client.input.append(buffer, static_cast<size_t>(n));
+
+                bool closing = false;
+                size_t length = completeResponse(client.input, closing);
+                if (length == 0)
+                    continue;
+
+                latencies.push_back(chrono::duration<double, micro>(chrono::steady_clock::now() - client.sent_at).count());
+                client.input.erase(0, length);
+
+                // The server caps requests per connection; reconnect like a browser would
+                if (closing)
+                {
+                    close(client.fd);
+                    client.fd = -1;
+                    client.input.clear();
+                }
+                if (started < requests && !issue(client))
+                {
+                    cerr << "Reconnect failed" << endl;
+                    return {};
+                }
+            }
+        }
+
+        for (Client &client : clients)
+        {
+            if (client.fd != -1)
+                close(client.fd);
+        }
+        close(epoll_fd);
+        return latencies;
+    }
+
+    double percentile(vector<double> &sorted, double fraction)
+    {
+        size_t index = min(sorted.size() - 1, static_cast<size_t>(fraction * static_cast<double>(sorted.size())));
+        return sorted[index];
+    }
+
+    bool measure(int port, int connections, int requests)
+    {
+        // Warm up caches, the connection pool and the CPU frequency
+        if (runLoad(port, connections, max(1000, requests / 10)).empty())
+            return false;
+
+        ServerCounters before, after;
+        fetchCounters(port, before);
+        auto start = chrono::steady_clock::now();
+        vector<double> latencies = runLoad(port, connections, requests);
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        fetchCounters(port, after);
+        if (latencies.empty())
+            return false;
+
+        sort(latencies.begin(), latencies.end());
+        // The stats request itself is one of the served requests
+        double served = static_cast<double>(max<uint64_t>(1, after.requests - before.requests - 1));
+
+        cout << left << setw(10) << after.backend << right << fixed << setprecision(0)
+             << setw(10) << latencies.size() / seconds
+             << setprecision(1) << setw(10) << percentile(latencies, 0.50)
+             << setw(10) << percentile(latencies, 0.99) << setw(10) << percentile(latencies, 0.999)
+             << setprecision(2) << setw(14) << (after.syscalls - before.syscalls) / served
+             << setw(14) << (after.wakeups - before.wakeups) / served << "\n";
+        return true;
+    }
+
+    pid_t startServer(const string &path, int port, const string &backend)
+    {
+        cout.flush(); // or the child's freopen writes our buffer out again
+        pid_t pid = fork();
+        if (pid == 0)
+        {
+            // Keep the startup banner out of the table
+            freopen("/dev/null", "w", stdout);
+            string port_text = to_string(port);
+            execl(path.c_str(), path.c_str(), "--port", port_text.c_str(), "--backend", backend.c_str(),
+                  static_cast<char *>(nullptr));
+            _exit(127);
+        }
+
+        for (int attempt = 0; attempt < 100; ++attempt)
+        {
+            usleep(50000);
+            int fd = connectTo(port);
+            if (fd != -1)
+            {
+                close(fd);
+                return pid;
+            }
+        }
+        kill(pid, SIGKILL);
+        waitpid(pid, nullptr, 0);
+        return -1;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    string server_path;
+    int port = 8080;
+    int connections = 32;
+    int requests = 100000;
+
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        string arg = argv[i];
+        if (arg == "--server")
+            server_path = argv[i + 1];
+        else if (arg == "--port")
+            port = atoi(argv[i + 1]);
+        else if (arg == "--connections")
+            connections = max(1, atoi(argv[i + 1]));
+        else if (arg == "--requests")
+            requests = max(1, atoi(argv[i + 1]));
+    }
+
+    cout << "POST /api/calculate, " << requests << " requests over " << connections
+         << " keep-alive connections\n\n";
+    cout << left << setw(10) << "backend" << right << setw(10) << "req/s" << setw(10) << "p50 us"
+         << setw(10) << "p99 us" << setw(10) << "p99.9 us" << setw(14) << "syscalls/req"
+         << setw(14) << "wakeups/req" << "\n";
+
+    if (server_path.empty())
+    {
+        return measure(port, connections, requests) ? 0 : 1;
+    }
+
+    for (const char *backend : {"epoll", "io_uring"})
+    {
+        pid_t pid = startServer(server_path, port, backend);
+        if (pid == -1)
+        {
+            cerr << "Server did not start with --backend " << backend << endl;
+            return 1;
+        }
+        bool ok = measure(port, connections, requests);
+        kill(pid, SIGTERM);
+        waitpid(pid, nullptr, 0);
+        if (!ok)
+            return 1;
+    }
+
+    cout << "\nsyscalls/req counts the server's network calls (epoll_wait, epoll_ctl,\n"
+            "accept4, recv, sendmsg, shutdown, close, io_uring_enter). wakeups/req is\n"
+            "how often the epoll loops had to wake a parked worker, roughly two\n"
+            "futex calls each; io_uring handles requests on the loop threads.\n";
+    return 0;
+}
@@ -0,0 +1,394 @@
+// Offline bulk scoring: reads a candidate CSV, scores every row with the
+// same rules as the server's /api/calculate and writes one result per
+// row, in input order, as CSV or NDJSON.
+//
+//   lasu_bulk_score INPUT.csv [--output PATH] [--format csv|ndjson] [--threads N]
+//
+// The input format is described in cohort_csv.h. The file is
+// memory-mapped, split into chunks at line breaks, and each chunk is
+// parsed and scored on its own thread.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "candidate_store.h"
+#include "cohort_csv.h"
+#include "json_writer.h"
+
+using namespace std;
+
+namespace
+{
+    enum class OutputFormat
+    {
+        Csv,
+        Ndjson
+    };
+
+    // Read-only view of a whole file
+    class MappedFile
+    {
+    public:
+        // Throws runtime_error if the file cannot be opened or mapped
+        explicit MappedFile(const string &path)
+        {
+            int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+            if (fd == -1)
+            {
+                throw runtime_error("Cannot open " + path + ": " + strerror(errno));
+            }
+            struct stat info;
+            if (fstat(fd, &info) == -1)
+            {
+                int error = errno;
+                close(fd);
+                throw runtime_error("Cannot stat " + path + ": " + strerror(error));
+            }
+            if (!S_ISREG(info.st_mode))
+            {
+                close(fd);
+                throw runtime_error(path + " is not a regular file, so it cannot be mapped");
+            }
+            size = static_cast<size_t>(info.st_size);
+            if (size > 0)
+            {
+                data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+            }
+            close(fd);
+            if (data == MAP_FAILED)
+            {
+                throw runtime_error("Cannot map " + path + ": " + strerror(errno));
+            }
+            if (size > 0)
+            {
+                // Chunks are read concurrently, not front to back
+                madvise(data, size, MADV_WILLNEED);
+            }
+        }
+
+        ~MappedFile()
+        {
+            if (size > 0)
+                munmap(data, size);
+        }
+
+        MappedFile(const MappedFile &) = delete;
+        MappedFile &operator=(const MappedFile &) = delete;
+
+        string_view text() const { return string_view(static_cast<const char *>(data), size); }
+
+    private:
+        void *data = nullptr;
+        size_t size = 0;
+    };
+
+    struct Chunk
+    {
+        string_view lines;
+        string output;
+        size_t candidates = 0;
+        size_t errors = 0;
+        size_t invalid_grades = 0;
+        bool done = false;
+    };
+
+    class BulkScorer
+    {
+    public:
+        BulkScorer(const CsvLayout &layout, OutputFormat output_format)
+            : format(output_format), reader(layout)
+        {
+        }
+
+        // Parses, scores and renders every line of `chunk`
+        void run(Chunk &chunk)
+        {
+            store.clear();
+            rows.clear();
+            chunk.output.reserve(chunk.lines.size() * 2);
+
+            forEachCsvRow(chunk.lines, [this, &chunk](string_view line)
+                          { readCandidate(line, chunk); });
+
+            store.score();
+            size_t scored = 0;
+            for (const Row &row : rows)
+            {
+                if (row.error)
+                    renderError(row, chunk.output);
+                else
+                    renderResult(row, scored++, chunk.output);
+            }
+            chunk.candidates = rows.size();
+        }
+
+    private:
+        struct Row
+        {
+            string id;
+            const char *error; // nullptr once added to the store
+        };
+
+        OutputFormat format;
+        CohortRowReader reader;
+        CandidateStore store;
+        vector<Row> rows;
+        string id;
+        CandidateGrades grades;
+
+        void readCandidate(string_view line, Chunk &chunk)
+        {
+            int course_category, jamb_score;
+            const char *error = reader.read(line, id, course_category, jamb_score, grades, chunk.invalid_grades);
+            rows.push_back({id, error});
+            if (error)
+            {
+                ++chunk.errors;
+                return;
+            }
+            store.add(jamb_score, course_category, grades);
+        }
+
+        static void appendCsvField(string &out, string_view text)
+        {
+            if (text.find_first_of(",\"\r\n") == string_view::npos)
+            {
+                out.append(text);
+                return;
+            }
+            out += '"';
+            for (char c : text)
+            {
+                if (c == '"')
+                    out += '"';
+                out += c;
+            }
+            out += '"';
+        }
+
+        void renderError(const Row &row, string &out) const
+        {
+            if (format == OutputFormat::Csv)
+            {
+                appendCsvField(out, row.id);
+                out.append(",,,,,,,,");
+                out.append(row.error);
+                out += '\n';
+                return;
+            }
+            out.append("{\"id\": \"");
+            appendJsonEscaped(out, row.id);
+            out.append("\",\"error\": \"");
+            out.append(row.error);
+            out.append("\"}\n");
+        }
+
+        void renderResult(const Row &row, size_t i, string &out) const
+        {
+            int jamb_score = store.jamb_score[i];
+            string_view admission = admissionStatusText(static_cast<AdmissionStatus>(store.admission[i]));
+            string_view status = statusClassName(static_cast<StatusClass>(store.status[i]));
+
+            if (format == OutputFormat::Csv)
+            {
+                appendCsvField(out, row.id);
+                out += ',';
+                appendInteger(out, jamb_score);
+                out += ',';
+                appendFixed1(out, (jamb_score / 400.0) * 60.0);
+                out += ',';
+                appendInteger(out, store.waec_total[i]);
+                out += ',';
+                appendFixed1(out, store.waec_percentage[i]);
+                out += ',';
+                appendFixed1(out, store.final_score[i]);
+                out += ',';
+                out.append(admission);
+                out += ',';
+                out.append(status);
+                out.append(",\n");
+                return;
+            }
+
+            // The /api/calculate response with the id in front
+            out.append("{\"id\": \"");
+            appendJsonEscaped(out, row.id);
+            out.append("\",\"jambScore\": ");
+            appendInteger(out, jamb_score);
+            out.append(",\"jambPercentage\": ");
+            appendFixed1(out, (jamb_score / 400.0) * 60.0);
+            out.append(",\"waecScore\": ");
+            appendInteger(out, store.waec_total[i]);
+            out.append(",\"waecPercentage\": ");
+            appendFixed1(out, store.waec_percentage[i]);
+            out.append(",\"finalScore\": ");
+            appendFixed1(out, store.final_score[i]);
+            out.append(",\"admissionStatus\": \"");
+            out.append(admission);
+            out.append("\",\"status\": \"");
+            out.append(status);
+            out.append("\"}\n");
+        }
+    };
+
+    void printUsage(const char *program)
+    {
+        cerr << "Usage: " << program << " INPUT.csv [--output PATH] [--format csv|ndjson] [--threads N]\n"
+             << "  --output PATH        where results go (default stdout)\n"
+             << "  --format csv|ndjson  result format (default csv)\n"
+             << "  --threads N          scoring threads, one per core if 0 (default)\n";
+    }
+}
+
+int main(int argc, char **argv)
+{
+    string input_path;
+    string output_path;
+    OutputFormat format = OutputFormat::Csv;
+    unsigned threads = 0;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        string arg = argv[i];
+        if (arg == "--output" && i + 1 < argc)
+        {
+            output_path = argv[++i];
+        }
+        else if (arg == "--format" && i + 1 < argc)
+        {
+            string name = argv[++i];
+            if (name != "csv" && name != "ndjson")
+            {
+                printUsage(argv[0]);
+                return 1;
+            }
+            format = name == "ndjson" ? OutputFormat::Ndjson : OutputFormat::Csv;
+        }
+        else if (arg == "--threads" && i + 1 < argc)
+        {
+            threads = static_cast<unsigned>(max(0, atoi(argv[++i])));
+        }
+        else if (arg[0] != '-' && input_path.empty())
+        {
+            input_path = arg;
+        }
+        else
+        {
+            printUsage(argv[0]);
+            return arg == "--help" || arg == "-h" ? 0 : 1;
+        }
+    }
+    if (input_path.empty())
+    {
+        printUsage(argv[0]);
+        return 1;
+    }
+    if (threads == 0)
+    {
+        threads = max(1u, thread::hardware_concurrency());
+    }
+
+    try
+    {
+        auto started = chrono::steady_clock::now();
+        MappedFile input(input_path);
+        string_view text = input.text();
+        CsvLayout layout = readCohortHeader(text);
+        ScreeningTable::global();
+
+        FILE *output = output_path.empty() ? stdout : fopen(output_path.c_str(), "wb");
+        if (!output)
+        {
+            throw runtime_error("Cannot create " + output_path + ": " + strerror(errno));
+        }
+        if (format == OutputFormat::Csv)
+        {
+            fputs("id,jambScore,jambPercentage,waecScore,waecPercentage,finalScore,admissionStatus,status,error\n",
+                  output);
+        }
+
+        // Small enough to spread evenly over the threads, big enough that
+        // a chunk fills the store's vector loops
+        vector<Chunk> chunks;
+        for (string_view piece : splitAtLineBreaks(text, 1 << 20))
+        {
+            chunks.emplace_back();
+            chunks.back().lines = piece;
+        }
+
+        atomic<size_t> next_chunk(0);
+        mutex done_mutex;
+        condition_variable done_cv;
+        vector<thread> workers;
+        for (unsigned t = 0; t < min<size_t>(threads, max<size_t>(1, chunks.size())); ++t)
+        {
+            workers.emplace_back([&]
+                                 {
+                                     BulkScorer scorer(layout, format);
+                                     size_t index;
+                                     while ((index = next_chunk.fetch_add(1)) < chunks.size())
+                                     {
+                                         scorer.run(chunks[index]);
+                                         lock_guard<mutex> lock(done_mutex);
+                                         chunks[index].done = true;
+                                         done_cv.notify_all();
+                                     } });
+        }
+
+        // Write chunks in input order as they finish
+        size_t candidates = 0, errors = 0, invalid_grades = 0;
+        bool write_failed = false;
+        for (Chunk &chunk : chunks)
+        {
+            {
+                unique_lock<mutex> lock(done_mutex);
+                done_cv.wait(lock, [&chunk]
+                             { return chunk.done; });
+            }
+            write_failed |= fwrite(chunk.output.data(), 1, chunk.output.size(), output) != chunk.output.size();
+            string().swap(chunk.output);
+            candidates += chunk.candidates;
+            errors += chunk.errors;
+            invalid_grades += chunk.invalid_grades;
+        }
+        for (thread &worker : workers)
+        {
+            worker.join();
+        }
+        write_failed |= fflush(output) != 0;
+        if (output != stdout)
+        {
+            write_failed |= fclose(output) != 0;
+        }
+        if (write_failed)
+        {
+            throw runtime_error("Failed writing results: " + string(strerror(errno)));
+        }
+
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - started).count();
+        cerr << "Scored " << candidates << " candidates (" << errors << " rejected, " << invalid_grades
+             << " invalid grades skipped) in " << seconds << "s on " << workers.size() << " threads, "
+             << scoringKernelName(bestScoringKernel()) << " kernel" << endl;
+    }
+    catch (const exception &e)
+    {
+        cerr << "Error: " << e.what() << endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,495 @@
+#pragma once
+
+// Columnar candidate store for cohort-sized scoring runs. Every field is
+// its own contiguous array, so scoring streams through a few bytes per
+// candidate instead of chasing one LASUScreeningAggregator object each,
+// and a SIMD kernel scores 8 (AVX2) or 16 (AVX-512) candidates per step.
+// The kernel is picked at runtime from the CPU's features; the scalar
+// kernel reads the ScreeningTable, and the vector kernels must agree with
+// it bit for bit (lasu_store_bench checks that they do).
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <vector>
+
+#include "screening_rules.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define LASU_HAVE_X86_KERNELS 1
+#include <immintrin.h>
+#endif
+
+enum class ScoringKernel
+{
+    Scalar,
+    Avx2,
+    Avx512
+};
+
+inline const char *scoringKernelName(ScoringKernel kernel)
+{
+    switch (kernel)
+    {
+    case ScoringKernel::Avx2:
+        return "avx2";
+    case ScoringKernel::Avx512:
+        return "avx512";
+    default:
+        return "scalar";
+    }
+}
+
+inline bool scoringKernelSupported(ScoringKernel kernel)
+{
+#ifdef LASU_HAVE_X86_KERNELS
+    switch (kernel)
+    {
+    case ScoringKernel::Avx2:
+        return __builtin_cpu_supports("avx2");
+    case ScoringKernel::Avx512:
+        return __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw");
+    default:
+        return true;
+    }
+#else
+    return kernel == ScoringKernel::Scalar;
+#endif
+}
+
+// Widest kernel this CPU runs
+inline ScoringKernel bestScoringKernel()
+{
+    static const ScoringKernel best = scoringKernelSupported(ScoringKernel::Avx512) ? ScoringKernel::Avx512
+                                      : scoringKernelSupported(ScoringKernel::Avx2) ? ScoringKernel::Avx2
+                                                                                    : ScoringKernel::Scalar;
+    return best;
+}
+
+class CandidateStore
+{
+public:
+    // Only the best optional grade ever counts, so a few slots are enough
+    static constexpr size_t optional_slots = 4;
+    static constexpr uint8_t no_optional = 0xFF;
+
+    // Inputs, one entry per candidate. Required grades are resolved when a
+    // candidate is added: column i holds the grade for the faculty's i-th
+    // required subject, Grade::None when missing or past required_count.
+    // Optional columns hold the best grades in the order they were given,
+    // Grade::None in unused slots.
+    std::vector<int16_t> jamb_score;
+    std::vector<uint8_t> faculty; // facultyId(), 0 for an unknown category
+    std::vector<uint8_t> required_grade[FacultyPolicy::max_required];
+    std::vector<uint8_t> optional_grade[optional_slots];
+    std::vector<SubjectId> optional_subject[optional_slots];
+
+    // Outputs, filled in by score()
+    std::vector<uint8_t> waec_total;
+    std::vector<uint8_t> waec_max_points;
+    std::vector<uint8_t> best_optional; // optional slot that counted, or no_optional
+    std::vector<double> waec_percentage;
+    std::vector<double> final_score;
+    std::vector<uint8_t> admission; // AdmissionStatus
+    std::vector<uint8_t> status;    // StatusClass
+
+    explicit CandidateStore(ScoringKernel scoring_kernel = bestScoringKernel()) : kernel(scoring_kernel) {}
+
+    size_t size() const { return jamb_score.size(); }
+    ScoringKernel scoringKernel() const { return kernel; }
+
+    void reserve(size_t count)
+    {
+        forEachColumn([count](auto &column)
+                      { column.reserve(count); });
+    }
+
+    void clear()
+    {
+        forEachColumn([](auto &column)
+                      { column.clear(); });
+    }
+
+    // Adds a candidate the way LASUScreeningAggregator takes one: a JAMB
+    // score outside 0-400 counts as 0 and an unknown course category
+    // scores with no required subjects. Returns the candidate's index.
+    size_t add(int jamb, int course_category, const CandidateGrades &grades)
+    {
+        const FacultyPolicy &policy = facultyPolicy(course_category);
+        jamb_score.push_back(static_cast<int16_t>(jamb >= 0 && jamb <= 400 ? jamb : 0));
+        faculty.push_back(static_cast<uint8_t>(facultyId(policy)));
+        for (size_t i = 0; i < FacultyPolicy::max_required; ++i)
+        {
+            Grade grade = i < policy.required_count ? grades.requiredGrade(policy.required[i]) : Grade::None;
+            required_grade[i].push_back(static_cast<uint8_t>(grade));
+        }
+
+        // Keep the best few, in their original order so ties still go to
+        // the first one given
+        size_t kept[CandidateGrades::max_subjects];
+        size_t count = grades.optional_count;
+        for (size_t i = 0; i < count; ++i)
+        {
+            kept[i] = i;
+        }
+        if (count > optional_slots)
+        {
+            std::nth_element(kept, kept + optional_slots - 1, kept + count, [&grades](size_t a, size_t b)
+                             { return grades.optional[a].grade != grades.optional[b].grade
+                                          ? grades.optional[a].grade < grades.optional[b].grade
+                                          : a < b; });
+            std::sort(kept, kept + optional_slots);
+            count = optional_slots;
+        }
+        for (size_t slot = 0; slot < optional_slots; ++slot)
+        {
+            bool used = slot < count;
+            optional_grade[slot].push_back(static_cast<uint8_t>(used ? grades.optional[kept[slot]].grade : Grade::None));
+            optional_subject[slot].push_back(used ? grades.optional[kept[slot]].subject : SubjectDictionary::unknown);
+        }
+
+        waec_total.push_back(0);
+        waec_max_points.push_back(0);
+        best_optional.push_back(no_optional);
+        waec_percentage.push_back(0.0);
+        final_score.push_back(0.0);
+        admission.push_back(static_cast<uint8_t>(AdmissionStatus::Poor));
+        status.push_back(static_cast<uint8_t>(StatusClass::Poor));
+        return size() - 1;
+    }
+
+    // Scores candidates [begin, end). Disjoint ranges may be scored from
+    // different threads at once.
+    void score(size_t begin, size_t end)
+    {
+        end = std::min(end, size());
+        size_t done = begin;
+        FacultyLanes lanes(ScreeningTable::global());
+#ifdef LASU_HAVE_X86_KERNELS
+        if (kernel == ScoringKernel::Avx512)
+        {
+            done = scoreAvx512(lanes, begin, end);
+        }
+        else if (kernel == ScoringKernel::Avx2)
+        {
+            done = scoreAvx2(lanes, begin, end);
+        }
+#endif
+        scoreScalar(lanes, done, end);
+    }
+
+    void score() { score(0, size()); }
+
+private:
+    ScoringKernel kernel;
+
+    template <typename Visit>
+    void forEachColumn(Visit visit)
+    {
+        visit(jamb_score);
+        visit(faculty);
+        for (auto &column : required_grade)
+            visit(column);
+        for (auto &column : optional_grade)
+            visit(column);
+        for (auto &column : optional_subject)
+            visit(column);
+        visit(waec_total);
+        visit(waec_max_points);
+        visit(best_optional);
+        visit(waec_percentage);
+        visit(final_score);
+        visit(admission);
+        visit(status);
+    }
+
+    // Faculty policies spread into lanes the vector kernels can index by
+    // faculty ID; 16 entries so AVX-512 can keep each in registers. Taken
+    // afresh for every score() call, from one snapshot of each faculty's
+    // published bands, so every kernel in the call judges a faculty
+    // against the same cutoff.
+    struct alignas(64) FacultyLanes
+    {
+        int32_t max_points[16];
+        int32_t counts_best_optional[16]; // all ones or zero
+        double excellent_from[16];
+        double good_from[16];
+        double fair_from[16];
+        const ScreeningTable::Bands *bands[16];
+
+        explicit FacultyLanes(const ScreeningTable &table)
+            : max_points(), counts_best_optional(), excellent_from(), good_from(), fair_from(), bands()
+        {
+            static_assert(std::size(faculty_policies) <= 16, "faculty IDs must fit the lanes");
+            for (int id = 0; id <= faculty_count; ++id)
+            {
+                const FacultyPolicy &policy = faculty_policies[id];
+                bands[id] = &table.bands(id);
+                double cutoff = bands[id]->cutoff;
+                max_points[id] = policy.max_points;
+                counts_best_optional[id] = policy.counts_best_optional ? -1 : 0;
+                excellent_from[id] = cutoff + 10;
+                good_from[id] = cutoff;
+                fair_from[id] = cutoff - 10;
+            }
+        }
+    };
+
+    void scoreScalar(const FacultyLanes &lanes, size_t begin, size_t end)
+    {
+        const ScreeningTable &table = ScreeningTable::global();
+        for (size_t i = begin; i < end; ++i)
+        {
+            const FacultyPolicy &policy = faculty_policies[faculty[i]];
+            int total = 0;
+            for (size_t slot = 0; slot < FacultyPolicy::max_required; ++slot)
+            {
+                total += gradePoints(static_cast<Grade>(required_grade[slot][i]));
+            }
+
+            uint8_t best = no_optional;
+            for (size_t slot = 0; slot < optional_slots; ++slot)
+            {
+                uint8_t grade = optional_grade[slot][i];
+                if (grade != static_cast<uint8_t>(Grade::None) &&
+                    (best == no_optional || grade < optional_grade[best][i]))
+                {
+                    best = static_cast<uint8_t>(slot);
+                }
+            }
+
+            int max_points = policy.max_points;
+            if (!policy.counts_best_optional)
+            {
+                best = no_optional;
+            }
+            else if (best != no_optional)
+            {
+                total += gradePoints(static_cast<Grade>(optional_grade[best][i]));
+                max_points += 8;
+            }
+
+            ScreeningTable::Outcome outcome = table.lookup(*lanes.bands[faculty[i]], jamb_score[i], total, max_points);
+            waec_total[i] = static_cast<uint8_t>(total);
+            waec_max_points[i] = static_cast<uint8_t>(max_points);
+            best_optional[i] = best;
+            waec_percentage[i] = (total / (double)max_points) * 40.0;
+            final_score[i] = outcome.final_score;
+            admission[i] = static_cast<uint8_t>(outcome.admission);
+            status[i] = static_cast<uint8_t>(outcome.status);
+        }
+    }
+
+#ifdef LASU_HAVE_X86_KERNELS
+// GCC's intrinsics seed their results with _mm*_undefined_*(), which its
+// own uninitialized-use analysis then reports from inside the headers
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+
+    // Grade code to points in 32-bit lanes: 8 - code, so None (9) gives -1
+    // and is clamped to 0
+    __attribute__((target("avx2"))) static __m256i pointsAvx2(const uint8_t *grades)
+    {
+        __m256i codes = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(grades)));
+        return _mm256_max_epi32(_mm256_sub_epi32(_mm256_set1_epi32(8), codes), _mm256_setzero_si256());
+    }
+
+    __attribute__((target("avx2"))) static void storeBytesAvx2(uint8_t *out, __m256i values)
+    {
+        __m128i words = _mm_packus_epi32(_mm256_castsi256_si128(values), _mm256_extracti128_si256(values, 1));
+        _mm_storel_epi64(reinterpret_cast<__m128i *>(out), _mm_packus_epi16(words, words));
+    }
+
+    // 3 minus the number of thresholds met, from two halves of 64-bit
+    // compare masks (all ones when met), as bytes
+    __attribute__((target("avx2"))) static void storeBandsAvx2(uint8_t *out, __m256d low_met[3], __m256d high_met[3])
+    {
+        __m256i low = _mm256_set1_epi64x(3);
+        __m256i high = low;
+        for (int t = 0; t < 3; ++t)
+        {
+            low = _mm256_add_epi64(low, _mm256_castpd_si256(low_met[t]));
+            high = _mm256_add_epi64(high, _mm256_castpd_si256(high_met[t]));
+        }
+        // Low dword of each 64-bit lane, both halves in one register
+        __m256i pick = _mm256_setr_epi32(0, 2, 4, 6, 0, 2, 4, 6);
+        __m256i both = _mm256_permute2x128_si256(_mm256_permutevar8x32_epi32(low, pick),
+                                                 _mm256_permutevar8x32_epi32(high, pick), 0x20);
+        storeBytesAvx2(out, both);
+    }
+
+    __attribute__((target("avx2"))) size_t scoreAvx2(const FacultyLanes &lanes, size_t begin, size_t end)
+    {
+        const __m256i none = _mm256_set1_epi32(static_cast<int>(Grade::None));
+        size_t i = begin;
+        for (; i + 8 <= end; i += 8)
+        {
+            __m256i faculty_ids = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(&faculty[i])));
+
+            __m256i total = _mm256_setzero_si256();
+            for (size_t slot = 0; slot < FacultyPolicy::max_required; ++slot)
+            {
+                total = _mm256_add_epi32(total, pointsAvx2(&required_grade[slot][i]));
+            }
+
+            // Best optional: strictly more points wins, so ties keep the
+            // earlier slot; -1 points while no slot is filled
+            __m256i best_points = _mm256_set1_epi32(-1);
+            __m256i best_slot = _mm256_set1_epi32(no_optional);
+            for (size_t slot = 0; slot < optional_slots; ++slot)
+            {
+                __m256i codes = _mm256_cvtepu8_epi32(
+                    _mm_loadl_epi64(reinterpret_cast<const __m128i *>(&optional_grade[slot][i])));
+                __m256i points = _mm256_sub_epi32(_mm256_set1_epi32(8), codes);
+                __m256i better = _mm256_andnot_si256(_mm256_cmpeq_epi32(codes, none),
+                                                     _mm256_cmpgt_epi32(points, best_points));
+                best_points = _mm256_blendv_epi8(best_points, points, better);
+                best_slot = _mm256_blendv_epi8(best_slot, _mm256_set1_epi32(static_cast<int>(slot)), better);
+            }
+
+            __m256i counts = _mm256_i32gather_epi32(lanes.counts_best_optional, faculty_ids, 4);
+            __m256i counted = _mm256_and_si256(counts, _mm256_cmpgt_epi32(best_points, _mm256_set1_epi32(-1)));
+            total = _mm256_add_epi32(total, _mm256_and_si256(counted, best_points));
+            __m256i max_points = _mm256_add_epi32(_mm256_i32gather_epi32(lanes.max_points, faculty_ids, 4),
+                                                  _mm256_and_si256(counted, _mm256_set1_epi32(8)));
+            best_slot = _mm256_blendv_epi8(_mm256_set1_epi32(no_optional), best_slot, counted);
+
+            storeBytesAvx2(&waec_total[i], total);
+            storeBytesAvx2(&waec_max_points[i], max_points);
+            storeBytesAvx2(&best_optional[i], best_slot);
+
+            __m256i jamb = _mm256_cvtepi16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(&jamb_score[i])));
+            __m256d status_met[2][3];
+            __m256d admission_met[2][3];
+            for (int half = 0; half < 2; ++half)
+            {
+                __m128i half_ids = half ? _mm256_extracti128_si256(faculty_ids, 1) : _mm256_castsi256_si128(faculty_ids);
+                __m256d jamb_d = _mm256_cvtepi32_pd(half ? _mm256_extracti128_si256(jamb, 1) : _mm256_castsi256_si128(jamb));
+                __m256d total_d = _mm256_cvtepi32_pd(half ? _mm256_extracti128_si256(total, 1) : _mm256_castsi256_si128(total));
+                __m256d max_d = _mm256_cvtepi32_pd(half ? _mm256_extracti128_si256(max_points, 1) : _mm256_castsi256_si128(max_points));
+
+                // Same operations in the same order as JAMBAllocation and WAECAllocation
+                __m256d jamb_part = _mm256_mul_pd(_mm256_div_pd(jamb_d, _mm256_set1_pd(400.0)), _mm256_set1_pd(60.0));
+                __m256d waec_part = _mm256_mul_pd(_mm256_div_pd(total_d, max_d), _mm256_set1_pd(40.0));
+                __m256d score = _mm256_add_pd(jamb_part, waec_part);
+                _mm256_storeu_pd(&waec_percentage[i + 4 * half], waec_part);
+                _mm256_storeu_pd(&final_score[i + 4 * half], score);
+
+                status_met[half][0] = _mm256_cmp_pd(score, _mm256_set1_pd(70.0), _CMP_GE_OQ);
+                status_met[half][1] = _mm256_cmp_pd(score, _mm256_set1_pd(60.0), _CMP_GE_OQ);
+                status_met[half][2] = _mm256_cmp_pd(score, _mm256_set1_pd(50.0), _CMP_GE_OQ);
+                admission_met[half][0] = _mm256_cmp_pd(score, _mm256_i32gather_pd(lanes.excellent_from, half_ids, 8), _CMP_GE_OQ);
+                admission_met[half][1] = _mm256_cmp_pd(score, _mm256_i32gather_pd(lanes.good_from, half_ids, 8), _CMP_GE_OQ);
+                admission_met[half][2] = _mm256_cmp_pd(score, _mm256_i32gather_pd(lanes.fair_from, half_ids, 8), _CMP_GE_OQ);
+            }
+            storeBandsAvx2(&status[i], status_met[0], status_met[1]);
+            storeBandsAvx2(&admission[i], admission_met[0], admission_met[1]);
+        }
+        return i;
+    }
+
+    __attribute__((target("avx512f,avx512bw"))) static __m512i loadBytesAvx512(const uint8_t *bytes)
+    {
+        return _mm512_cvtepu8_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(bytes)));
+    }
+
+    // Lanes 0-7 or 8-15; the extract index has to be a constant even when
+    // the loop over halves is not unrolled
+    __attribute__((target("avx512f"))) static __m256i halfAvx512(__m512i lanes, int half)
+    {
+        return half ? _mm512_extracti64x4_epi64(lanes, 1) : _mm512_castsi512_si256(lanes);
+    }
+
+    __attribute__((target("avx512f,avx512bw"))) size_t scoreAvx512(const FacultyLanes &lanes, size_t begin, size_t end)
+    {
+        const __m512i max_points_lanes = _mm512_load_si512(lanes.max_points);
+        const __m512i counts_lanes = _mm512_load_si512(lanes.counts_best_optional);
+        const __m512d thresholds[3][2] = {
+            {_mm512_load_pd(lanes.excellent_from), _mm512_load_pd(lanes.excellent_from + 8)},
+            {_mm512_load_pd(lanes.good_from), _mm512_load_pd(lanes.good_from + 8)},
+            {_mm512_load_pd(lanes.fair_from), _mm512_load_pd(lanes.fair_from + 8)}};
+        const double status_from[3] = {70.0, 60.0, 50.0};
+        const __m512i eight = _mm512_set1_epi32(8);
+        const __m512i one = _mm512_set1_epi32(1);
+
+        size_t i = begin;
+        for (; i + 16 <= end; i += 16)
+        {
+            __m512i faculty_ids = loadBytesAvx512(&faculty[i]);
+
+            __m512i total = _mm512_setzero_si512();
+            for (size_t slot = 0; slot < FacultyPolicy::max_required; ++slot)
+            {
+                __m512i points = _mm512_sub_epi32(eight, loadBytesAvx512(&required_grade[slot][i]));
+                total = _mm512_add_epi32(total, _mm512_max_epi32(points, _mm512_setzero_si512()));
+            }
+
+            __m512i best_points = _mm512_set1_epi32(-1);
+            __m512i best_slot = _mm512_set1_epi32(no_optional);
+            for (size_t slot = 0; slot < optional_slots; ++slot)
+            {
+                __m512i codes = loadBytesAvx512(&optional_grade[slot][i]);
+                __m512i points = _mm512_sub_epi32(eight, codes);
+                __mmask16 better = _mm512_cmpgt_epi32_mask(points, best_points) &
+                                   _mm512_cmpneq_epi32_mask(codes, _mm512_set1_epi32(static_cast<int>(Grade::None)));
+                best_points = _mm512_mask_mov_epi32(best_points, better, points);
+                best_slot = _mm512_mask_mov_epi32(best_slot, better, _mm512_set1_epi32(static_cast<int>(slot)));
+            }
+
+            __mmask16 counted = _mm512_test_epi32_mask(_mm512_permutexvar_epi32(faculty_ids, counts_lanes),
+                                                       _mm512_set1_epi32(-1)) &
+                                _mm512_cmpge_epi32_mask(best_points, _mm512_setzero_si512());
+            total = _mm512_mask_add_epi32(total, counted, total, best_points);
+            __m512i max_points = _mm512_permutexvar_epi32(faculty_ids, max_points_lanes);
+            max_points = _mm512_mask_add_epi32(max_points, counted, max_points, eight);
+            best_slot = _mm512_mask_mov_epi32(_mm512_set1_epi32(no_optional), counted, best_slot);
+
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(&waec_total[i]), _mm512_cvtepi32_epi8(total));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(&waec_max_points[i]), _mm512_cvtepi32_epi8(max_points));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(&best_optional[i]), _mm512_cvtepi32_epi8(best_slot));
+
+            __m512i jamb = _mm512_cvtepi16_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(&jamb_score[i])));
+            __m512i status_codes = _mm512_set1_epi32(3);
+            __m512i admission_codes = _mm512_set1_epi32(3);
+            for (int half = 0; half < 2; ++half)
+            {
+                __m512i half_ids = _mm512_cvtepu32_epi64(halfAvx512(faculty_ids, half));
+                __m512d jamb_d = _mm512_cvtepi32_pd(halfAvx512(jamb, half));
+                __m512d total_d = _mm512_cvtepi32_pd(halfAvx512(total, half));
+                __m512d max_d = _mm512_cvtepi32_pd(halfAvx512(max_points, half));
+
+                // Same operations in the same order as JAMBAllocation and WAECAllocation.
+                // AVX-512 brings FMA along, and a fused multiply-add rounds
+                // once instead of twice; the explicit-rounding add is never
+                // contracted into one.
+                __m512d jamb_part = _mm512_mul_pd(_mm512_div_pd(jamb_d, _mm512_set1_pd(400.0)), _mm512_set1_pd(60.0));
+                __m512d waec_part = _mm512_mul_pd(_mm512_div_pd(total_d, max_d), _mm512_set1_pd(40.0));
+                __m512d score = _mm512_add_round_pd(jamb_part, waec_part, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+                _mm512_storeu_pd(&waec_percentage[i + 8 * half], waec_part);
+                _mm512_storeu_pd(&final_score[i + 8 * half], score);
+
+                int shift = 8 * half;
+                for (int t = 0; t < 3; ++t)
+                {
+                    __mmask16 status_met = static_cast<__mmask16>(
+                        _mm512_cmp_pd_mask(score, _mm512_set1_pd(status_from[t]), _CMP_GE_OQ) << shift);
+                    __m512d from = _mm512_permutex2var_pd(thresholds[t][0], half_ids, thresholds[t][1]);
+                    __mmask16 admission_met = static_cast<__mmask16>(_mm512_cmp_pd_mask(score, from, _CMP_GE_OQ) << shift);
+                    status_codes = _mm512_mask_sub_epi32(status_codes, status_met, status_codes, one);
+                    admission_codes = _mm512_mask_sub_epi32(admission_codes, admission_met, admission_codes, one);
+                }
+            }
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(&status[i]), _mm512_cvtepi32_epi8(status_codes));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(&admission[i]), _mm512_cvtepi32_epi8(admission_codes));
+        }
+        return i;
+    }
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+#endif
+};
@@ -0,0 +1,278 @@
+#pragma once
+
+// Candidate cohorts as CSV, read by lasu_bulk_score and by the server's
+// --cohort. The text starts with a header row; columns are found by name,
+// in any order, and unknown ones are ignored:
+//   id                optional, copied to the output
+//   courseCategory    1-11
+//   jambScore         0-400
+//   <subject>         WAEC grade for a catalog subject ("Mathematics",
+//                     "English_Language", ...), blank if not taken
+//   optionalSubjects  "Name:Grade;Name:Grade"
+// Fields may be quoted but must not contain line breaks, so the rows can
+// be cut into chunks at line breaks and parsed on separate threads.
+
+#include <algorithm>
+#include <charconv>
+#include <deque>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+#include "screening_rules.h"
+
+// Splits one CSV line into fields. Quoted fields lose their quotes and
+// have "" collapsed, which needs `scratch`; it keeps one string per field
+// (a deque, so growing it moves none) and the views stay valid until the
+// next call.
+inline void splitCsvLine(std::string_view line, std::vector<std::string_view> &fields, std::deque<std::string> &scratch)
+{
+    fields.clear();
+    size_t pos = 0;
+    while (true)
+    {
+        if (pos < line.size() && line[pos] == '"')
+        {
+            if (scratch.size() <= fields.size())
+            {
+                scratch.resize(fields.size() + 1);
+            }
+            std::string &field = scratch[fields.size()];
+            field.clear();
+            ++pos;
+            while (pos < line.size())
+            {
+                if (line[pos] == '"')
+                {
+                    if (pos + 1 < line.size() && line[pos + 1] == '"')
+                    {
+                        field += '"';
+                        pos += 2;
+                        continue;
+                    }
+                    ++pos;
+                    break;
+                }
+                field += line[pos++];
+            }
+            fields.push_back(field);
+            pos = std::min(line.find(',', pos), line.size());
+        }
+        else
+        {
+            size_t end = std::min(line.find(',', pos), line.size());
+            fields.push_back(line.substr(pos, end - pos));
+            pos = end;
+        }
+
+        if (pos >= line.size())
+        {
+            return;
+        }
+        ++pos; // the comma
+    }
+}
+
+inline std::string_view trimField(std::string_view text)
+{
+    size_t begin = text.find_first_not_of(" \t");
+    if (begin == std::string_view::npos)
+    {
+        return {};
+    }
+    return text.substr(begin, text.find_last_not_of(" \t") - begin + 1);
+}
+
+// Where each input field lives, from the header row
+struct CsvLayout
+{
+    static const size_t none = static_cast<size_t>(-1);
+
+    size_t id = none;
+    size_t course_category = none;
+    size_t jamb_score = none;
+    size_t optional_subjects = none;
+    std::vector<SubjectId> required_subject; // per column, unknown if not a subject
+
+    explicit CsvLayout(std::string_view header)
+    {
+        std::vector<std::string_view> fields;
+        std::deque<std::string> scratch;
+        splitCsvLine(header, fields, scratch);
+        required_subject.assign(fields.size(), SubjectDictionary::unknown);
+        for (size_t column = 0; column < fields.size(); ++column)
+        {
+            std::string name(trimField(fields[column]));
+            if (name == "id")
+                id = column;
+            else if (name == "courseCategory")
+                course_category = column;
+            else if (name == "jambScore")
+                jamb_score = column;
+            else if (name == "optionalSubjects")
+                optional_subjects = column;
+            else
+            {
+                // Form field names use underscores for spaces
+                std::replace(name.begin(), name.end(), '_', ' ');
+                SubjectId subject = SubjectDictionary::global().find(name);
+                if (subject < static_cast<SubjectId>(Subject::Count))
+                {
+                    required_subject[column] = subject;
+                }
+            }
+        }
+    }
+};
+
+// Takes the header row (and any byte order mark) off the front of `text`,
+// leaving the data rows. Throws runtime_error if the header lacks the
+// columns every row needs.
+inline CsvLayout readCohortHeader(std::string_view &text)
+{
+    if (text.substr(0, 3) == "\xEF\xBB\xBF")
+    {
+        text.remove_prefix(3);
+    }
+    size_t header_end = std::min(text.find('\n'), text.size());
+    std::string_view header = text.substr(0, header_end);
+    if (!header.empty() && header.back() == '\r')
+    {
+        header.remove_suffix(1);
+    }
+    text.remove_prefix(std::min(header_end + 1, text.size()));
+
+    CsvLayout layout(header);
+    if (layout.course_category == CsvLayout::none || layout.jamb_score == CsvLayout::none)
+    {
+        throw std::runtime_error("The header needs courseCategory and jambScore columns");
+    }
+    return layout;
+}
+
+// Cuts `rows` into pieces of roughly `target` bytes that end at line breaks
+inline std::vector<std::string_view> splitAtLineBreaks(std::string_view rows, size_t target)
+{
+    std::vector<std::string_view> pieces;
+    for (size_t start = 0; start < rows.size();)
+    {
+        size_t end = start + target;
+        if (end >= rows.size())
+        {
+            end = rows.size();
+        }
+        else
+        {
+            end = rows.find('\n', end);
+            end = end == std::string_view::npos ? rows.size() : end + 1;
+        }
+        pieces.push_back(rows.substr(start, end - start));
+        start = end;
+    }
+    return pieces;
+}
+
+// Calls visit(line) for every line of `rows` with anything in it, line
+// endings removed
+template <typename Visit>
+void forEachCsvRow(std::string_view rows, Visit visit)
+{
+    for (size_t start = 0; start < rows.size();)
+    {
+        size_t end = std::min(rows.find('\n', start), rows.size());
+        std::string_view line = rows.substr(start, end - start);
+        start = end + 1;
+        if (!line.empty() && line.back() == '\r')
+        {
+            line.remove_suffix(1);
+        }
+        if (line.find_first_not_of(" \t,") != std::string_view::npos)
+        {
+            visit(line);
+        }
+    }
+}
+
+// Parses data rows laid out by a CsvLayout into candidates. One per
+// thread: it keeps scratch space between rows.
+class CohortRowReader
+{
+public:
+    explicit CohortRowReader(const CsvLayout &csv_layout) : layout(csv_layout) {}
+
+    // Reads one row into `id` and the other out-parameters. Returns the
+    // reason a row is refused, or nullptr. Grades that are not A1-F9 are
+    // skipped and counted in `invalid_grades`, as WAECAllocation::addGrade
+    // and addOptionalSubject skip them.
+    const char *read(std::string_view line, std::string &id, int &course_category, int &jamb_score,
+                     CandidateGrades &grades, size_t &invalid_grades)
+    {
+        splitCsvLine(line, fields, scratch);
+        id.assign(field(layout.id));
+        grades = CandidateGrades();
+
+        course_category = integerField(field(layout.course_category));
+        jamb_score = integerField(field(layout.jamb_score));
+        // Refused like the server refuses them: missing, zero or negative
+        if (course_category <= 0 || jamb_score <= 0)
+        {
+            return "Invalid course category or JAMB score";
+        }
+
+        for (size_t column = 0; column < fields.size() && column < layout.required_subject.size(); ++column)
+        {
+            SubjectId subject = layout.required_subject[column];
+            std::string_view text = field(column);
+            if (subject == SubjectDictionary::unknown || text.empty())
+            {
+                continue;
+            }
+            Grade grade = parseGrade(text);
+            if (grade == Grade::None)
+                ++invalid_grades;
+            else
+                grades.setRequired(subject, grade);
+        }
+
+        std::string_view optional = field(layout.optional_subjects);
+        for (size_t start = 0; start < optional.size();)
+        {
+            size_t end = std::min(optional.find(';', start), optional.size());
+            std::string_view entry = optional.substr(start, end - start);
+            start = end + 1;
+            size_t colon = entry.rfind(':');
+            if (colon == std::string_view::npos)
+            {
+                continue;
+            }
+            std::string_view name = trimField(entry.substr(0, colon));
+            Grade grade = parseGrade(trimField(entry.substr(colon + 1)));
+            if (name.empty())
+                continue;
+            if (grade == Grade::None)
+                ++invalid_grades;
+            else
+                grades.addOptional(SubjectDictionary::global().intern(name), grade);
+        }
+        return nullptr;
+    }
+
+private:
+    const CsvLayout &layout;
+    std::vector<std::string_view> fields;
+    std::deque<std::string> scratch;
+
+    std::string_view field(size_t column) const
+    {
+        return column < fields.size() ? trimField(fields[column]) : std::string_view();
+    }
+
+    static int integerField(std::string_view text)
+    {
+        int value = 0;
+        auto result = std::from_chars(text.data(), text.data() + text.size(), value);
+        return result.ec == std::errc() && result.ptr == text.data() + text.size() ? value : 0;
+    }
+};
@@ -0,0 +1,101 @@
+#pragma once
+
+// Cutoffs from admission quotas, solved once at startup over the cohort
+// the operator loads with --cohort. For each faculty with a quota the
+// candidates on its merit list are partially ordered with nth_element
+// until the quota-th best is in place; its final score becomes the
+// faculty's cutoff, so exactly the candidates who would fill the quota
+// score at or above it. Faculties are solved in parallel, one at a time
+// per thread.
+//
+// Candidates tied on final score with the last admitted are all at or
+// above the cutoff, so `admitted` can exceed the quota by the size of
+// that tie. Tie-breaking by JAMB, WAEC and ID only decides who counts as
+// last admitted.
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "merit_list.h"
+#include "screening_rules.h"
+
+struct QuotaCutoff
+{
+    int faculty = 0;
+    size_t quota = 0;       // 0: no quota, the cutoff is left alone
+    size_t candidates = 0;  // current candidates on the faculty's list
+    double cutoff = 0.0;    // score that fills the quota
+    size_t admitted = 0;    // candidates at or above the cutoff
+    std::string last_admitted;
+};
+
+// quotas[f] is faculty f's quota (1-11; index 0 ignored). Faculties with
+// no quota, or no candidates, keep their current cutoff in the result.
+inline std::vector<QuotaCutoff> solveQuotaCutoffs(const MeritList &merit_list, const std::vector<size_t> &quotas,
+                                                  unsigned threads)
+{
+    const ScreeningTable &table = ScreeningTable::global();
+    std::vector<QuotaCutoff> results;
+    for (int faculty = 1; faculty <= faculty_count; ++faculty)
+    {
+        QuotaCutoff result;
+        result.faculty = faculty;
+        result.quota = static_cast<size_t>(faculty) < quotas.size() ? quotas[faculty] : 0;
+        result.cutoff = table.cutoff(faculty);
+        results.push_back(result);
+    }
+
+    std::atomic<size_t> next{0};
+    auto solve = [&]()
+    {
+        for (size_t i = next.fetch_add(1); i < results.size(); i = next.fetch_add(1))
+        {
+            QuotaCutoff &result = results[i];
+            if (result.quota == 0)
+            {
+                result.candidates = merit_list.candidates(result.faculty);
+                continue;
+            }
+
+            std::vector<RankKey> keys = merit_list.rankKeys(result.faculty);
+            result.candidates = keys.size();
+            if (keys.empty())
+            {
+                continue;
+            }
+
+            // A quota above the field admits everyone: the cutoff drops to
+            // the weakest candidate
+            size_t filled = std::min(result.quota, keys.size());
+            auto boundary = keys.begin() + static_cast<std::ptrdiff_t>(filled - 1);
+            std::nth_element(keys.begin(), boundary, keys.end(), keyRanksAbove);
+            result.cutoff = boundary->final_score;
+            result.last_admitted = boundary->entry->candidate_id;
+            result.admitted = filled;
+            for (auto it = boundary + 1; it != keys.end(); ++it)
+            {
+                if (it->final_score >= result.cutoff)
+                {
+                    ++result.admitted;
+                }
+            }
+        }
+    };
+
+    std::vector<std::thread> helpers;
+    size_t wanted = std::min<size_t>(std::max(1u, threads), results.size());
+    for (size_t t = 1; t < wanted; ++t)
+    {
+        helpers.emplace_back(solve);
+    }
+    solve();
+    for (std::thread &helper : helpers)
+    {
+        helper.join();
+    }
+    return results;
+}
@@ -0,0 +1,299 @@
+#pragma once
+
+// Minimal io_uring wrapper over the raw system calls, for the optional
+// io_uring networking backend. Only what the server needs is here: one
+// submission/completion ring per thread, and provided buffer rings so
+// multishot receives can pick their own buffers.
+//
+// LASU_HAVE_IO_URING is defined when the kernel headers are available;
+// whether the running kernel supports everything is checked at runtime.
+
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#define LASU_HAVE_IO_URING 1
+#endif
+#endif
+
+#ifdef LASU_HAVE_IO_URING
+
+#include <linux/io_uring.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+class IoUring
+{
+public:
+    // Throws runtime_error if the kernel refuses the ring (too old, or
+    // io_uring disabled by sysctl or seccomp). The creating thread must be
+    // the only one that submits.
+    explicit IoUring(unsigned entries)
+    {
+        io_uring_params params;
+        std::memset(&params, 0, sizeof(params));
+        params.flags = IORING_SETUP_SUBMIT_ALL | IORING_SETUP_COOP_TASKRUN |
+                       IORING_SETUP_SINGLE_ISSUER | IORING_SETUP_DEFER_TASKRUN;
+        params.flags |= IORING_SETUP_CQSIZE;
+        params.cq_entries = entries * 4;
+
+        ring_fd = static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+        if (ring_fd < 0)
+        {
+            throw std::runtime_error(std::string("io_uring_setup failed: ") + std::strerror(errno));
+        }
+        if (!(params.features & IORING_FEAT_SINGLE_MMAP) || !(params.features & IORING_FEAT_EXT_ARG))
+        {
+            close(ring_fd);
+            throw std::runtime_error("io_uring is too old (needs single mmap and extended arguments)");
+        }
+
+        ring_size = std::max(params.sq_off.array + params.sq_entries * sizeof(uint32_t),
+                             params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe));
+        ring_memory = mmap(nullptr, ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                           ring_fd, IORING_OFF_SQ_RING);
+        sqe_size = params.sq_entries * sizeof(io_uring_sqe);
+        void *sqe_memory = mmap(nullptr, sqe_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                                ring_fd, IORING_OFF_SQES);
+        if (ring_memory == MAP_FAILED || sqe_memory == MAP_FAILED)
+        {
+            if (ring_memory != MAP_FAILED)
+                munmap(ring_memory, ring_size);
+            close(ring_fd);
+            throw std::runtime_error("Failed to map io_uring rings");
+        }
+
+        char *base = static_cast<char *>(ring_memory);
+        sq_tail = reinterpret_cast<unsigned *>(base + params.sq_off.tail);
+        sq_mask = *reinterpret_cast<unsigned *>(base + params.sq_off.ring_mask);
+        sq_entries = params.sq_entries;
+        sqes = static_cast<io_uring_sqe *>(sqe_memory);
+
+        // Slot i of the indirection array always points at SQE i
+        unsigned *sq_array = reinterpret_cast<unsigned *>(base + params.sq_off.array);
+        for (unsigned i = 0; i < sq_entries; ++i)
+        {
+            sq_array[i] = i;
+        }
+
+        cq_head = reinterpret_cast<unsigned *>(base + params.cq_off.head);
+        cq_tail = reinterpret_cast<unsigned *>(base + params.cq_off.tail);
+        cq_mask = *reinterpret_cast<unsigned *>(base + params.cq_off.ring_mask);
+        cqes = reinterpret_cast<io_uring_cqe *>(base + params.cq_off.cqes);
+
+        sqe_tail = *sq_tail;
+        submitted_tail = sqe_tail;
+    }
+
+    ~IoUring()
+    {
+        munmap(sqes, sqe_size);
+        munmap(ring_memory, ring_size);
+        close(ring_fd);
+    }
+
+    IoUring(const IoUring &) = delete;
+    IoUring &operator=(const IoUring &) = delete;
+
+    int fd() const { return ring_fd; }
+
+    // io_uring_enter calls made so far, the ring's whole syscall cost
+    uint64_t enterCalls() const { return enter_calls; }
+
+    // A zeroed SQE to fill in; nothing reaches the kernel until the next
+    // submitAndWait(). If the queue is full it is flushed first.
+    io_uring_sqe *getSqe()
+    {
+        if (sqe_tail - submitted_tail == sq_entries)
+        {
+            submitAndWait(0, 0);
+        }
+        io_uring_sqe *sqe = &sqes[sqe_tail & sq_mask];
+        std::memset(sqe, 0, sizeof(*sqe));
+        ++sqe_tail;
+        return sqe;
+    }
+
+    // Submits everything queued and waits for at least `wait_for`
+    // completions or `timeout_ms`, in a single io_uring_enter. Returns the
+    // number submitted, or -errno; a timeout is not an error.
+    int submitAndWait(unsigned wait_for, int timeout_ms)
+    {
+        unsigned to_submit = sqe_tail - submitted_tail;
+        __atomic_store_n(sq_tail, sqe_tail, __ATOMIC_RELEASE);
+
+        __kernel_timespec timeout;
+        timeout.tv_sec = timeout_ms / 1000;
+        timeout.tv_nsec = (timeout_ms % 1000) * 1000000LL;
+
+        io_uring_getevents_arg arg;
+        std::memset(&arg, 0, sizeof(arg));
+        arg.sigmask_sz = _NSIG / 8;
+        arg.ts = reinterpret_cast<uint64_t>(&timeout);
+
+        ++enter_calls;
+        int submitted = static_cast<int>(syscall(__NR_io_uring_enter, ring_fd, to_submit, wait_for,
+                                                 IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG,
+                                                 &arg, sizeof(arg)));
+        if (submitted < 0)
+        {
+            // Whatever was queued stays queued for the next call
+            return errno == ETIME || errno == EINTR ? 0 : -errno;
+        }
+        submitted_tail += static_cast<unsigned>(submitted);
+        return submitted;
+    }
+
+    // Hands every ready completion to `handler` and releases them
+    template <typename Handler>
+    unsigned forEachCompletion(Handler &&handler)
+    {
+        unsigned head = *cq_head;
+        unsigned tail = __atomic_load_n(cq_tail, __ATOMIC_ACQUIRE);
+        unsigned seen = 0;
+        while (head != tail)
+        {
+            handler(cqes[head & cq_mask]);
+            ++head;
+            ++seen;
+            // The handler may have flushed submissions; pick up new arrivals
+            if (head == tail)
+            {
+                tail = __atomic_load_n(cq_tail, __ATOMIC_ACQUIRE);
+            }
+        }
+        __atomic_store_n(cq_head, head, __ATOMIC_RELEASE);
+        return seen;
+    }
+
+private:
+    int ring_fd = -1;
+    void *ring_memory = nullptr;
+    size_t ring_size = 0;
+    size_t sqe_size = 0;
+
+    unsigned *sq_tail = nullptr;
+    unsigned sq_mask = 0;
+    unsigned sq_entries = 0;
+    io_uring_sqe *sqes = nullptr;
+    unsigned sqe_tail = 0;       // next free SQE (ours)
+    unsigned submitted_tail = 0; // how far the kernel has consumed
+
+    unsigned *cq_head = nullptr;
+    unsigned *cq_tail = nullptr;
+    unsigned cq_mask = 0;
+    io_uring_cqe *cqes = nullptr;
+
+    uint64_t enter_calls = 0;
+};
+
+// A group of equal-sized buffers the kernel picks from for receives with
+// IOSQE_BUFFER_SELECT. A completion names its buffer in the CQE flags;
+// the owner copies the data out and recycles the buffer straight away.
+class IoUringBufferRing
+{
+public:
+    // `count` must be a power of two
+    IoUringBufferRing(IoUring &owner, uint16_t group_id, unsigned count, unsigned buffer_size)
+        : ring(owner), group(group_id), entries(count), size(buffer_size)
+    {
+        ring_bytes = entries * sizeof(io_uring_buf);
+        pool_bytes = static_cast<size_t>(entries) * size;
+        void *ring_memory = mmap(nullptr, ring_bytes, PROT_READ | PROT_WRITE,
+                                 MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        void *pool_memory = mmap(nullptr, pool_bytes, PROT_READ | PROT_WRITE,
+                                 MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (ring_memory == MAP_FAILED || pool_memory == MAP_FAILED)
+        {
+            release(ring_memory, pool_memory);
+            throw std::runtime_error("Failed to allocate io_uring buffers");
+        }
+        buffers = static_cast<io_uring_buf *>(ring_memory);
+        pool = static_cast<char *>(pool_memory);
+
+        io_uring_buf_reg registration;
+        std::memset(&registration, 0, sizeof(registration));
+        registration.ring_addr = reinterpret_cast<uint64_t>(buffers);
+        registration.ring_entries = entries;
+        registration.bgid = group;
+        if (syscall(__NR_io_uring_register, ring.fd(), IORING_REGISTER_PBUF_RING, &registration, 1) != 0)
+        {
+            int error = errno;
+            release(ring_memory, pool_memory);
+            throw std::runtime_error(std::string("Provided buffer rings unsupported: ") + std::strerror(error));
+        }
+
+        for (unsigned id = 0; id < entries; ++id)
+        {
+            place(static_cast<uint16_t>(id));
+        }
+        publish();
+    }
+
+    ~IoUringBufferRing()
+    {
+        io_uring_buf_reg registration;
+        std::memset(&registration, 0, sizeof(registration));
+        registration.bgid = group;
+        syscall(__NR_io_uring_register, ring.fd(), IORING_UNREGISTER_PBUF_RING, &registration, 1);
+        release(buffers, pool);
+    }
+
+    IoUringBufferRing(const IoUringBufferRing &) = delete;
+    IoUringBufferRing &operator=(const IoUringBufferRing &) = delete;
+
+    uint16_t groupId() const { return group; }
+    const char *data(uint16_t id) const { return pool + static_cast<size_t>(id) * size; }
+
+    // Gives a buffer back to the kernel
+    void recycle(uint16_t id)
+    {
+        place(id);
+        publish();
+    }
+
+private:
+    IoUring &ring;
+    uint16_t group;
+    unsigned entries;
+    unsigned size;
+    size_t ring_bytes = 0;
+    size_t pool_bytes = 0;
+    // The kernel header's io_uring_buf_ring declares its flexible array in
+    // a way C++ lays out 8 bytes late, so the ring is addressed as a plain
+    // array; the tail overlays the reserved field of slot 0.
+    io_uring_buf *buffers = nullptr;
+    char *pool = nullptr;
+    uint16_t tail = 0;
+
+    void place(uint16_t id)
+    {
+        io_uring_buf &slot = buffers[tail & (entries - 1)];
+        slot.addr = reinterpret_cast<uint64_t>(pool + static_cast<size_t>(id) * size);
+        slot.len = size;
+        slot.bid = id;
+        ++tail;
+    }
+
+    void publish()
+    {
+        __atomic_store_n(&buffers[0].resv, tail, __ATOMIC_RELEASE);
+    }
+
+    void release(void *ring_memory, void *pool_memory)
+    {
+        if (ring_memory != MAP_FAILED && ring_memory != nullptr)
+            munmap(ring_memory, ring_bytes);
+        if (pool_memory != MAP_FAILED && pool_memory != nullptr)
+            munmap(pool_memory, pool_bytes);
+    }
+};
+
+#endif // LASU_HAVE_IO_URING
@@ -0,0 +1,526 @@
+#pragma once
+
+#include <charconv>
+#include <cstdint>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+// Pull-style JSON tokenizer over a string_view. The caller walks the
+// document in the shape it expects and skips whatever it does not care
+// about with skipValue(), which copes with any nesting. Errors are sticky:
+// the first one is kept in error() and every later call fails fast.
+class JsonReader
+{
+public:
+    static const size_t max_depth = 64;
+
+    explicit JsonReader(std::string_view json) : text(json) {}
+
+    bool ok() const { return error_message == nullptr; }
+    const char *error() const { return error_message ? error_message : ""; }
+
+    // Next significant character without consuming it, '\0' at the end
+    char peek()
+    {
+        skipWhitespace();
+        return pos < text.size() ? text[pos] : '\0';
+    }
+
+    bool beginObject() { return beginContainer('{'); }
+    bool beginArray() { return beginContainer('['); }
+
+    // Advances to the next member of the current object. Returns false once
+    // the closing brace has been consumed (or on error).
+    bool nextMember(std::string &key)
+    {
+        if (!nextItem('}'))
+        {
+            return false;
+        }
+        if (!readString(key))
+        {
+            return false;
+        }
+        if (peek() != ':')
+        {
+            return fail("Expected ':' after object key");
+        }
+        ++pos;
+        return true;
+    }
+
+    // Advances to the next element of the current array. Returns false once
+    // the closing bracket has been consumed (or on error).
+    bool nextElement() { return nextItem(']'); }
+
+    bool readString(std::string &out)
+    {
+        out.clear();
+        if (peek() != '"')
+        {
+            return fail("Expected a string");
+        }
+        ++pos;
+
+        while (pos < text.size())
+        {
+            // Copy unescaped runs in one go
+            size_t run = pos;
+            while (run < text.size() && text[run] != '"' && text[run] != '\\' &&
+                   static_cast<unsigned char>(text[run]) >= 0x20)
+            {
+                ++run;
+            }
+            out.append(text.data() + pos, run - pos);
+            pos = run;
+
+            if (pos == text.size())
+            {
+                break;
+            }
+
+            char c = text[pos++];
+            if (c == '"')
+            {
+                return true;
+            }
+            if (c != '\\')
+            {
+                return fail("Unescaped control character in string");
+            }
+            if (!readEscape(out))
+            {
+                return false;
+            }
+        }
+        return fail("Unterminated string");
+    }
+
+    bool readNumber(double &out)
+    {
+        skipWhitespace();
+        size_t start = pos;
+        if (pos < text.size() && text[pos] == '-')
+        {
+            ++pos;
+        }
+        if (pos < text.size() && text[pos] == '0')
+        {
+            ++pos;
+        }
+        else if (!consumeDigits())
+        {
+            return fail("Expected a number");
+        }
+        if (pos < text.size() && text[pos] == '.')
+        {
+            ++pos;
+            if (!consumeDigits())
+            {
+                return fail("Expected digits after decimal point");
+            }
+        }
+        if (pos < text.size() && (text[pos] == 'e' || text[pos] == 'E'))
+        {
+            ++pos;
+            if (pos < text.size() && (text[pos] == '+' || text[pos] == '-'))
+            {
+                ++pos;
+            }
+            if (!consumeDigits())
+            {
+                return fail("Expected digits in exponent");
+            }
+        }
+
+        auto result = std::from_chars(text.data() + start, text.data() + pos, out);
+        if (result.ec != std::errc())
+        {
+            return fail("Number out of range");
+        }
+        return true;
+    }
+
+    // Skips one complete value of any type, including nested containers
+    bool skipValue()
+    {
+        switch (peek())
+        {
+        case '{':
+        {
+            std::string key;
+            if (!beginObject())
+            {
+                return false;
+            }
+            while (nextMember(key))
+            {
+                if (!skipValue())
+                {
+                    return false;
+                }
+            }
+            return ok();
+        }
+        case '[':
+        {
+            if (!beginArray())
+            {
+                return false;
+            }
+            while (nextElement())
+            {
+                if (!skipValue())
+                {
+                    return false;
+                }
+            }
+            return ok();
+        }
+        case '"':
+            return readString(scratch);
+        case 't':
+            return consumeLiteral("true");
+        case 'f':
+            return consumeLiteral("false");
+        case 'n':
+            return consumeLiteral("null");
+        default:
+        {
+            double ignored;
+            return readNumber(ignored);
+        }
+        }
+    }
+
+    // Offset of the next unread character, e.g. to slice out a value that
+    // was just skipped
+    size_t offset() const { return pos; }
+
+    // True when only whitespace follows the top-level value
+    bool atEnd()
+    {
+        return ok() && peek() == '\0' && pos == text.size();
+    }
+
+private:
+    std::string_view text;
+    size_t pos = 0;
+    size_t depth = 0;
+    bool first_in_container[max_depth];
+    const char *error_message = nullptr;
+    std::string scratch;
+
+    bool fail(const char *message)
+    {
+        if (!error_message)
+        {
+            error_message = message;
+        }
+        pos = text.size();
+        return false;
+    }
+
+    void skipWhitespace()
+    {
+        while (pos < text.size() &&
+               (text[pos] == ' ' || text[pos] == '\t' || text[pos] == '\n' || text[pos] == '\r'))
+        {
+            ++pos;
+        }
+    }
+
+    bool consumeDigits()
+    {
+        size_t start = pos;
+        while (pos < text.size() && text[pos] >= '0' && text[pos] <= '9')
+        {
+            ++pos;
+        }
+        return pos > start;
+    }
+
+    bool consumeLiteral(std::string_view literal)
+    {
+        if (text.substr(pos, literal.size()) != literal)
+        {
+            return fail("Invalid literal");
+        }
+        pos += literal.size();
+        return true;
+    }
+
+    bool beginContainer(char open)
+    {
+        if (peek() != open)
+        {
+            return fail(open == '{' ? "Expected an object" : "Expected an array");
+        }
+        if (depth == max_depth)
+        {
+            return fail("Nesting too deep");
+        }
+        ++pos;
+        first_in_container[depth++] = true;
+        return true;
+    }
+
+    bool nextItem(char close)
+    {
+        if (!ok() || depth == 0)
+        {
+            return false;
+        }
+
+        char c = peek();
+        if (c == close)
+        {
+            ++pos;
+            --depth;
+            return false;
+        }
+
+        if (first_in_container[depth - 1])
+        {
+            first_in_container[depth - 1] = false;
+            return true;
+        }
+        if (c != ',')
+        {
+            return fail(close == '}' ? "Expected ',' or '}' in object" : "Expected ',' or ']' in array");
+        }
+        ++pos;
+        if (peek() == close)
+        {
+            return fail("Trailing comma");
+        }
+        return true;
+    }
+
+    bool readHex4(uint32_t &value)
+    {
+        if (text.size() - pos < 4)
+        {
+            return fail("Truncated \\u escape");
+        }
+        value = 0;
+        for (size_t i = 0; i < 4; ++i)
+        {
+            char c = text[pos++];
+            value <<= 4;
+            if (c >= '0' && c <= '9')
+                value |= static_cast<uint32_t>(c - '0');
+            else if (c >= 'a' && c <= 'f')
+                value |= static_cast<uint32_t>(c - 'a' + 10);
+            else if (c >= 'A' && c <= 'F')
+                value |= static_cast<uint32_t>(c - 'A' + 10);
+            else
+                return fail("Invalid \\u escape");
+        }
+        return true;
+    }
+
+    bool readEscape(std::string &out)
+    {
+        if (pos == text.size())
+        {
+            return fail("Unterminated string");
+        }
+
+        switch (text[pos++])
+        {
+        case '"': out += '"'; return true;
+        case '\\': out += '\\'; return true;
+        case '/': out += '/'; return true;
+        case 'b': out += '\b'; return true;
+        case 'f': out += '\f'; return true;
+        case 'n': out += '\n'; return true;
+        case 'r': out += '\r'; return true;
+        case 't': out += '\t'; return true;
+        case 'u':
+            break;
+        default:
+            return fail("Invalid escape sequence");
+        }
+
+        uint32_t code_point;
+        if (!readHex4(code_point))
+        {
+            return false;
+        }
+        if (code_point >= 0xD800 && code_point <= 0xDBFF)
+        {
+            uint32_t low;
+            if (text.substr(pos, 2) != "\\u")
+            {
+                return fail("Unpaired surrogate");
+            }
+            pos += 2;
+            if (!readHex4(low) || low < 0xDC00 || low > 0xDFFF)
+            {
+                return fail("Unpaired surrogate");
+            }
+            code_point = 0x10000 + ((code_point - 0xD800) << 10) + (low - 0xDC00);
+        }
+        else if (code_point >= 0xDC00 && code_point <= 0xDFFF)
+        {
+            return fail("Unpaired surrogate");
+        }
+
+        appendUtf8(out, code_point);
+        return true;
+    }
+
+    static void appendUtf8(std::string &out, uint32_t code_point)
+    {
+        if (code_point < 0x80)
+        {
+            out += static_cast<char>(code_point);
+        }
+        else if (code_point < 0x800)
+        {
+            out += static_cast<char>(0xC0 | (code_point >> 6));
+            out += static_cast<char>(0x80 | (code_point & 0x3F));
+        }
+        else if (code_point < 0x10000)
+        {
+            out += static_cast<char>(0xE0 | (code_point >> 12));
+            out += static_cast<char>(0x80 | ((code_point >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (code_point & 0x3F));
+        }
+        else
+        {
+            out += static_cast<char>(0xF0 | (code_point >> 18));
+            out += static_cast<char>(0x80 | ((code_point >> 12) & 0x3F));
+            out += static_cast<char>(0x80 | ((code_point >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (code_point & 0x3F));
+        }
+    }
+};
+
+// Body of POST /api/calculate:
+// {"jambScore": 250, "courseCategory": 1,
+//  "requiredSubjects": {"Mathematics": "A1", ...},
+//  "optionalSubjects": [{"name": "Biology", "grade": "B2"}, ...]}
+// The subject lists allocate from the resource it is built with, so a
+// server can place the whole request in a per-request arena.
+struct ScreeningRequest
+{
+    using Subjects = std::pmr::vector<std::pair<std::pmr::string, std::pmr::string>>;
+
+    int course_category = 0;
+    int jamb_score = 0;
+    Subjects required_subjects;
+    Subjects optional_subjects;
+
+    explicit ScreeningRequest(std::pmr::memory_resource *resource = std::pmr::get_default_resource())
+        : required_subjects(resource), optional_subjects(resource)
+    {
+    }
+};
+
+// Reads a screening request in a single pass. Unknown members and entries
+// of the wrong type are skipped, as the old extraction did; only malformed
+// JSON fails, with the reason in `error`.
+inline bool parseScreeningRequest(std::string_view body, ScreeningRequest &request, std::string &error)
+{
+    JsonReader reader(body);
+    std::string key;
+    std::string name;
+    std::string grade;
+
+    auto readInteger = [&reader](int &out)
+    {
+        if (reader.peek() == '-' || (reader.peek() >= '0' && reader.peek() <= '9'))
+        {
+            double value;
+            if (reader.readNumber(value))
+            {
+                out = (value > -1e9 && value < 1e9) ? static_cast<int>(value) : 0;
+            }
+            return;
+        }
+        reader.skipValue();
+    };
+
+    if (reader.beginObject())
+    {
+        while (reader.nextMember(key))
+        {
+            if (key == "courseCategory")
+            {
+                readInteger(request.course_category);
+            }
+            else if (key == "jambScore")
+            {
+                readInteger(request.jamb_score);
+            }
+            else if (key == "requiredSubjects" && reader.peek() == '{')
+            {
+                reader.beginObject();
+                while (reader.nextMember(name))
+                {
+                    if (reader.peek() != '"')
+                    {
+                        reader.skipValue();
+                        continue;
+                    }
+                    if (reader.readString(grade) && !name.empty() && !grade.empty())
+                    {
+                        // Form field names use underscores for spaces
+                        for (char &c : name)
+                        {
+                            if (c == '_')
+                                c = ' ';
+                        }
+                        request.required_subjects.emplace_back(name, grade);
+                    }
+                }
+            }
+            else if (key == "optionalSubjects" && reader.peek() == '[')
+            {
+                reader.beginArray();
+                while (reader.nextElement())
+                {
+                    if (reader.peek() != '{')
+                    {
+                        reader.skipValue();
+                        continue;
+                    }
+
+                    name.clear();
+                    grade.clear();
+                    reader.beginObject();
+                    while (reader.nextMember(key))
+                    {
+                        if (key == "name" && reader.peek() == '"')
+                            reader.readString(name);
+                        else if (key == "grade" && reader.peek() == '"')
+                            reader.readString(grade);
+                        else
+                            reader.skipValue();
+                    }
+                    if (!name.empty() && !grade.empty())
+                    {
+                        request.optional_subjects.emplace_back(name, grade);
+                    }
+                }
+            }
+            else
+            {
+                reader.skipValue();
+            }
+        }
+    }
+
+    if (!reader.atEnd())
+    {
+        error = reader.ok() ? "Unexpected data after JSON value" : reader.error();
+        return false;
+    }
+    return true;
+}
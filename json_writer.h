@@ -0,0 +1,66 @@
+#pragma once
+
+#include <charconv>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+// JSON output helpers for bodies rendered by hand. Numbers go through
+// to_chars, so the output never depends on the locale.
+
+// Escapes `text` for use inside a JSON string literal (quotes not
+// included), handing the output to `emit` as string_view pieces, so
+// writers with their own buffers share the same escaping
+template <typename Emit>
+void emitJsonEscaped(std::string_view text, Emit emit)
+{
+    static const char hex[] = "0123456789abcdef";
+    size_t run = 0;
+    for (size_t i = 0; i < text.size(); ++i)
+    {
+        unsigned char c = static_cast<unsigned char>(text[i]);
+        if (c >= 0x20 && c != '"' && c != '\\')
+        {
+            continue;
+        }
+        emit(text.substr(run, i - run));
+        if (c == '"' || c == '\\')
+        {
+            char pair[2] = {'\\', static_cast<char>(c)};
+            emit(std::string_view(pair, 2));
+        }
+        else
+        {
+            char code[6] = {'\\', 'u', '0', '0', hex[c >> 4], hex[c & 15]};
+            emit(std::string_view(code, 6));
+        }
+        run = i + 1;
+    }
+    emit(text.substr(run));
+}
+
+inline void appendJsonEscaped(std::string &out, std::string_view text)
+{
+    emitJsonEscaped(text, [&out](std::string_view piece)
+                    { out.append(piece.data(), piece.size()); });
+}
+
+inline void appendInteger(std::string &out, int64_t value)
+{
+    char digits[24];
+    out.append(digits, std::to_chars(digits, digits + sizeof(digits), value).ptr);
+}
+
+// Same digits as `fixed << setprecision(1)`
+inline void appendFixed1(std::string &out, double value)
+{
+    char digits[352]; // room for any double in fixed notation
+    out.append(digits, std::to_chars(digits, digits + sizeof(digits), value, std::chars_format::fixed, 1).ptr);
+}
+
+// Shortest digits that read back as the same double
+inline void appendShortest(std::string &out, double value)
+{
+    char digits[32];
+    out.append(digits, std::to_chars(digits, digits + sizeof(digits), value).ptr);
+}
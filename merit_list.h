@@ -0,0 +1,494 @@
+#pragma once
+
+// Per-faculty merit lists. Scored candidates are added from any thread;
+// each faculty keeps every candidate plus its current top K in a bounded
+// heap, so the published list is a copy of K entries rather than a sort
+// of the whole faculty. The full ranking of each faculty is sorted once
+// after a bulk load, on several threads with a sample sort, and read back
+// a page at a time.
+//
+// Ranking: higher final score first, then higher JAMB score, then higher
+// WAEC total, then candidate ID, so equal candidates always come out in
+// the same order whatever order they arrived in.
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <iterator>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "screening_rules.h"
+
+struct MeritEntry
+{
+    std::string candidate_id;
+    double final_score = 0.0;
+    int16_t jamb_score = 0;
+    uint8_t waec_total = 0;
+    uint8_t faculty = 0;
+    bool superseded = false; // a free slot: the candidate moved faculty
+};
+
+inline bool ranksAbove(const MeritEntry &a, const MeritEntry &b)
+{
+    if (a.final_score != b.final_score)
+        return a.final_score > b.final_score;
+    if (a.jamb_score != b.jamb_score)
+        return a.jamb_score > b.jamb_score;
+    if (a.waec_total != b.waec_total)
+        return a.waec_total > b.waec_total;
+    return a.candidate_id < b.candidate_id;
+}
+
+// The ranking fields of one entry, for selecting over a faculty without
+// copying candidate IDs. Only valid while the MeritList lives.
+struct RankKey
+{
+    double final_score;
+    int16_t jamb_score;
+    uint8_t waec_total;
+    const MeritEntry *entry;
+};
+
+inline bool keyRanksAbove(const RankKey &a, const RankKey &b)
+{
+    if (a.final_score != b.final_score)
+        return a.final_score > b.final_score;
+    if (a.jamb_score != b.jamb_score)
+        return a.jamb_score > b.jamb_score;
+    if (a.waec_total != b.waec_total)
+        return a.waec_total > b.waec_total;
+    return a.entry->candidate_id < b.entry->candidate_id;
+}
+
+// Sorts `items` on up to `threads` threads: splitters from a sorted
+// sample cut the input into one bucket per thread, every thread scatters
+// its slice into the buckets, and the buckets are then sorted
+// independently and are already in order. Small inputs just use std::sort.
+template <typename T, typename Less>
+void parallelSort(std::vector<T> &items, Less less, unsigned threads)
+{
+    const size_t min_per_thread = 16 * 1024;
+    size_t parts = std::min<size_t>(threads, items.size() / min_per_thread);
+    if (parts < 2)
+    {
+        std::sort(items.begin(), items.end(), less);
+        return;
+    }
+
+    // Splitters: every 32nd element of a sorted, evenly spaced sample
+    const size_t oversample = 32;
+    std::vector<T> sample;
+    sample.reserve(parts * oversample);
+    for (size_t i = 0; i < parts * oversample; ++i)
+    {
+        sample.push_back(items[i * items.size() / (parts * oversample)]);
+    }
+    std::sort(sample.begin(), sample.end(), less);
+    std::vector<T> splitters;
+    for (size_t p = 1; p < parts; ++p)
+    {
+        splitters.push_back(sample[p * oversample]);
+    }
+    auto bucketOf = [&](const T &item)
+    {
+        return static_cast<size_t>(std::upper_bound(splitters.begin(), splitters.end(), item, less) - splitters.begin());
+    };
+
+    auto runOnThreads = [parts](const std::function<void(size_t)> &work)
+    {
+        std::vector<std::thread> helpers;
+        for (size_t t = 1; t < parts; ++t)
+        {
+            helpers.emplace_back(work, t);
+        }
+        work(0);
+        for (std::thread &helper : helpers)
+        {
+            helper.join();
+        }
+    };
+
+    // counts[t * parts + b]: items from slice t that fall in bucket b,
+    // turned into output offsets once every slice has been counted
+    std::vector<size_t> counts(parts * parts, 0);
+    std::vector<uint32_t> bucket_of(items.size());
+    auto slice = [&](size_t t, size_t &begin, size_t &end)
+    {
+        begin = t * items.size() / parts;
+        end = (t + 1) * items.size() / parts;
+    };
+    runOnThreads([&](size_t t)
+                 {
+                     size_t begin, end;
+                     slice(t, begin, end);
+                     for (size_t i = begin; i < end; ++i)
+                     {
+                         bucket_of[i] = static_cast<uint32_t>(bucketOf(items[i]));
+                         ++counts[t * parts + bucket_of[i]];
+                     } });
+
+    std::vector<size_t> bucket_start(parts + 1, 0);
+    size_t offset = 0;
+    for (size_t b = 0; b < parts; ++b)
+    {
+        bucket_start[b] = offset;
+        for (size_t t = 0; t < parts; ++t)
+        {
+            size_t count = counts[t * parts + b];
+            counts[t * parts + b] = offset;
+            offset += count;
+        }
+    }
+    bucket_start[parts] = offset;
+
+    std::vector<T> scattered(items.size());
+    runOnThreads([&](size_t t)
+                 {
+                     size_t begin, end;
+                     slice(t, begin, end);
+                     for (size_t i = begin; i < end; ++i)
+                     {
+                         scattered[counts[t * parts + bucket_of[i]]++] = std::move(items[i]);
+                     } });
+
+    runOnThreads([&](size_t b)
+                 { std::sort(scattered.begin() + static_cast<std::ptrdiff_t>(bucket_start[b]),
+                             scattered.begin() + static_cast<std::ptrdiff_t>(bucket_start[b + 1]), less); });
+    items.swap(scattered);
+}
+
+class MeritList
+{
+public:
+    // `list_size` is K, the length of the published top list; at most
+    // `capacity` distinct candidates are held
+    MeritList(size_t list_size, size_t capacity) : top_k(std::max<size_t>(1, list_size)), max_candidates(capacity) {}
+
+    size_t listSize() const { return top_k; }
+    size_t capacity() const { return max_candidates; }
+
+    // Distinct candidates held, over all faculties
+    size_t size() const { return held.load(std::memory_order_relaxed); }
+
+    // Records a scored candidate under faculty `faculty` (1-11). A
+    // candidate scored again replaces their earlier entry, wherever it
+    // was, without taking more room. False for an unknown faculty, or for
+    // a new candidate once `capacity` candidates are held.
+    bool add(std::string_view candidate_id, int faculty, double final_score, int jamb_score, int waec_total)
+    {
+        if (faculty < 1 || faculty > faculty_count)
+        {
+            return false;
+        }
+
+        // The shard lock is held across both faculty updates, so two
+        // scorings of one candidate cannot interleave; faculty locks are
+        // never held while taking a shard lock
+        IdShard &shard = shards[std::hash<std::string_view>()(candidate_id) % shard_count];
+        std::lock_guard<std::mutex> shard_lock(shard.mutex);
+        auto found = shard.latest.find(candidate_id);
+        if (found == shard.latest.end())
+        {
+            if (held.fetch_add(1, std::memory_order_relaxed) >= max_candidates)
+            {
+                held.fetch_sub(1, std::memory_order_relaxed);
+                return false;
+            }
+            MeritEntry *entry = place(faculty, candidate_id, final_score, jamb_score, waec_total);
+            shard.latest.emplace(entry->candidate_id, entry);
+            return true;
+        }
+
+        MeritEntry *earlier = found->second;
+        if (earlier->faculty == faculty)
+        {
+            Ranking &ranking = rankings[faculty];
+            std::lock_guard<std::mutex> lock(ranking.mutex);
+            ranking.order_valid = false;
+            dropTop(ranking, earlier);
+            earlier->final_score = final_score;
+            earlier->jamb_score = static_cast<int16_t>(jamb_score);
+            earlier->waec_total = static_cast<uint8_t>(waec_total);
+            offerTop(ranking, earlier);
+            return true;
+        }
+
+        // The map key views the entry's own ID, so it moves to the new
+        // entry before the old slot can be handed to someone else
+        MeritEntry *entry = place(faculty, candidate_id, final_score, jamb_score, waec_total);
+        auto node = shard.latest.extract(found);
+        node.key() = entry->candidate_id;
+        node.mapped() = entry;
+        shard.latest.insert(std::move(node));
+        release(*earlier);
+        return true;
+    }
+
+    // Current candidates in the faculty
+    size_t candidates(int faculty) const
+    {
+        const Ranking &ranking = rankings[facultyIndex(faculty)];
+        std::lock_guard<std::mutex> lock(ranking.mutex);
+        return ranking.current;
+    }
+
+    // The faculty's top K, best first
+    std::vector<MeritEntry> top(int faculty) const
+    {
+        const Ranking &ranking = rankings[facultyIndex(faculty)];
+        std::vector<MeritEntry> list;
+        {
+            std::lock_guard<std::mutex> lock(ranking.mutex);
+            if (!ranking.heap_complete)
+            {
+                refillTop(ranking);
+            }
+            list.reserve(ranking.heap.size());
+            for (const MeritEntry *entry : ranking.heap)
+            {
+                list.push_back(*entry);
+            }
+        }
+        std::sort(list.begin(), list.end(), ranksAbove);
+        return list;
+    }
+
+    // Sorts every faculty's full ranking now, on up to `threads` threads,
+    // so page() only copies. For after a bulk load: each faculty's lock is
+    // held while it sorts. A later add() to a faculty leaves it to be
+    // sorted again, on one thread, by its next page().
+    void rank(unsigned threads)
+    {
+        for (Ranking &ranking : rankings)
+        {
+            std::lock_guard<std::mutex> lock(ranking.mutex);
+            if (!ranking.order_valid)
+            {
+                collectOrder(ranking);
+                parallelSort(ranking.order, keyRanksAbove, threads);
+                ranking.order_valid = true;
+            }
+        }
+    }
+
+    // Up to `limit` candidates of the faculty's full ranking, starting
+    // `offset` places below the best
+    std::vector<MeritEntry> page(int faculty, size_t offset, size_t limit) const
+    {
+        const Ranking &ranking = rankings[facultyIndex(faculty)];
+        std::vector<MeritEntry> list;
+        std::lock_guard<std::mutex> lock(ranking.mutex);
+        if (!ranking.order_valid)
+        {
+            collectOrder(ranking);
+            std::sort(ranking.order.begin(), ranking.order.end(), keyRanksAbove);
+            ranking.order_valid = true;
+        }
+        size_t begin = std::min(offset, ranking.order.size());
+        size_t end = begin + std::min(limit, ranking.order.size() - begin);
+        list.reserve(end - begin);
+        for (size_t i = begin; i < end; ++i)
+        {
+            list.push_back(*ranking.order[i].entry);
+        }
+        return list;
+    }
+
+    // Ranking keys of every current candidate in the faculty, unordered.
+    // The keys point into the list: use them before the next add().
+    std::vector<RankKey> rankKeys(int faculty) const
+    {
+        const Ranking &ranking = rankings[facultyIndex(faculty)];
+        std::vector<RankKey> keys;
+        std::lock_guard<std::mutex> lock(ranking.mutex);
+        keys.reserve(ranking.current);
+        for (const MeritEntry &entry : ranking.entries)
+        {
+            if (!entry.superseded)
+            {
+                keys.push_back({entry.final_score, entry.jamb_score, entry.waec_total, &entry});
+            }
+        }
+        return keys;
+    }
+
+private:
+    static const size_t shard_count = 16;
+
+    // One faculty. Entries live in a deque so pointers to them stay valid
+    // as it grows; slots freed by candidates who moved faculty are reused.
+    // `heap` holds the top entries with the weakest at the front: the
+    // whole top K while `heap_complete`, otherwise the top heap.size()
+    // after a top entry was taken out, until top() refills it.
+    struct Ranking
+    {
+        mutable std::mutex mutex;
+        std::deque<MeritEntry> entries;
+        std::vector<MeritEntry *> free_slots;
+        mutable std::vector<const MeritEntry *> heap;
+        mutable bool heap_complete = true;
+        size_t current = 0;
+        // Every current entry best first, while `order_valid`; any change
+        // to the faculty clears it
+        mutable std::vector<RankKey> order;
+        mutable bool order_valid = false;
+    };
+
+    // Latest entry per candidate ID, sharded by hash to spread the locking
+    struct IdShard
+    {
+        std::mutex mutex;
+        std::unordered_map<std::string_view, MeritEntry *> latest; // keys view the entry's own ID
+    };
+
+    size_t top_k;
+    size_t max_candidates;
+    std::atomic<size_t> held{0};
+    Ranking rankings[std::size(faculty_policies)];
+    IdShard shards[shard_count];
+
+    static size_t facultyIndex(int faculty)
+    {
+        return faculty >= 1 && faculty <= faculty_count ? static_cast<size_t>(faculty) : 0;
+    }
+
+    static bool heapOrder(const MeritEntry *a, const MeritEntry *b)
+    {
+        return ranksAbove(*a, *b);
+    }
+
+    MeritEntry *place(int faculty, std::string_view candidate_id, double final_score, int jamb_score, int waec_total)
+    {
+        Ranking &ranking = rankings[faculty];
+        std::lock_guard<std::mutex> lock(ranking.mutex);
+        MeritEntry *entry;
+        if (ranking.free_slots.empty())
+        {
+            ranking.entries.emplace_back();
+            entry = &ranking.entries.back();
+        }
+        else
+        {
+            entry = ranking.free_slots.back();
+            ranking.free_slots.pop_back();
+        }
+        entry->candidate_id.assign(candidate_id.data(), candidate_id.size());
+        entry->final_score = final_score;
+        entry->jamb_score = static_cast<int16_t>(jamb_score);
+        entry->waec_total = static_cast<uint8_t>(waec_total);
+        entry->faculty = static_cast<uint8_t>(faculty);
+        entry->superseded = false;
+        ++ranking.current;
+        ranking.order_valid = false;
+        offerTop(ranking, entry);
+        return entry;
+    }
+
+    void release(MeritEntry &entry)
+    {
+        Ranking &ranking = rankings[entry.faculty];
+        std::lock_guard<std::mutex> lock(ranking.mutex);
+        dropTop(ranking, &entry);
+        entry.superseded = true;
+        --ranking.current;
+        ranking.order_valid = false;
+        ranking.free_slots.push_back(&entry);
+        settleTop(ranking);
+    }
+
+    // Adds `entry` to the heap if it belongs there. While the heap is
+    // short, an entry that outranks its weakest is still in the top
+    // heap.size() + 1; anything weaker waits for the refill.
+    void offerTop(Ranking &ranking, const MeritEntry *entry) const
+    {
+        std::vector<const MeritEntry *> &heap = ranking.heap;
+        if (ranking.heap_complete && heap.size() < top_k)
+        {
+            heap.push_back(entry);
+            std::push_heap(heap.begin(), heap.end(), heapOrder);
+        }
+        else if (ranking.heap_complete && ranksAbove(*entry, *heap.front()))
+        {
+            std::pop_heap(heap.begin(), heap.end(), heapOrder);
+            heap.back() = entry;
+            std::push_heap(heap.begin(), heap.end(), heapOrder);
+        }
+        else if (!ranking.heap_complete && !heap.empty() && ranksAbove(*entry, *heap.front()))
+        {
+            heap.push_back(entry);
+            std::push_heap(heap.begin(), heap.end(), heapOrder);
+            settleTop(ranking);
+        }
+    }
+
+    // Takes `entry` out of the heap if it is there; O(K), no rescan
+    void dropTop(Ranking &ranking, const MeritEntry *entry) const
+    {
+        std::vector<const MeritEntry *> &heap = ranking.heap;
+        auto found = std::find(heap.begin(), heap.end(), entry);
+        if (found == heap.end())
+        {
+            return;
+        }
+        *found = heap.back();
+        heap.pop_back();
+        std::make_heap(heap.begin(), heap.end(), heapOrder);
+        ranking.heap_complete = false;
+        settleTop(ranking);
+    }
+
+    // The heap is complete again once nothing outside it can belong in it
+    void settleTop(Ranking &ranking) const
+    {
+        if (!ranking.heap_complete && ranking.heap.size() >= std::min(top_k, ranking.current))
+        {
+            ranking.heap_complete = true;
+        }
+    }
+
+    static void collectOrder(const Ranking &ranking)
+    {
+        ranking.order.clear();
+        ranking.order.reserve(ranking.current);
+        for (const MeritEntry &entry : ranking.entries)
+        {
+            if (!entry.superseded)
+            {
+                ranking.order.push_back({entry.final_score, entry.jamb_score, entry.waec_total, &entry});
+            }
+        }
+    }
+
+    // Picks the top K again from every current entry; done on read, once
+    // for however many top entries were taken out since
+    void refillTop(const Ranking &ranking) const
+    {
+        std::vector<const MeritEntry *> remaining;
+        remaining.reserve(ranking.current);
+        for (const MeritEntry &entry : ranking.entries)
+        {
+            if (!entry.superseded)
+            {
+                remaining.push_back(&entry);
+            }
+        }
+        if (remaining.size() > top_k)
+        {
+            std::nth_element(remaining.begin(), remaining.begin() + static_cast<std::ptrdiff_t>(top_k - 1),
+                             remaining.end(), heapOrder);
+            remaining.resize(top_k);
+        }
+        std::make_heap(remaining.begin(), remaining.end(), heapOrder);
+        ranking.heap.swap(remaining);
+        ranking.heap_complete = true;
+    }
+};
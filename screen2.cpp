@@ -1,16 +1,43 @@
 #include <iostream>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <thread>
 #include <memory>
+#include <memory_resource>
 #include <unordered_map>
+#include <unordered_set>
+#include <deque>
 #include <sstream>
 #include <chrono>
 #include <mutex>
 #include <algorithm>
 #include <iomanip>
+#include <cstring>
+#include <cstdio>
+#include <ctime>
+#include <charconv>
 #include <limits>
-#include <regex>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <fstream>
+
+#ifdef LASU_HAVE_ZLIB
+#include <zlib.h>
+#endif
+#ifdef LASU_HAVE_BROTLI
+#include <brotli/encode.h>
+#endif
+
+#include "candidate_store.h"
+#include "cohort_csv.h"
+#include "cutoff_solver.h"
+#include "json_reader.h"
+#include "json_writer.h"
+#include "merit_list.h"
+#include "screening_rules.h"
+#include "io_uring.h"
 
 #ifdef _WIN32
 #include <winsock2.h>
@@ -20,9 +47,21 @@ typedef int socklen_t;
 #else
 #include <sys/socket.h>
 #include <netinet/in.h>
+#include <netinet/tcp.h>
 #include <arpa/inet.h>
 #include <unistd.h>
 #include <fcntl.h>
+#include <errno.h>
+#include <signal.h>
+#ifdef __linux__
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/un.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sched.h>
+#endif
+#include <sys/uio.h>
 #define SOCKET int
 #define INVALID_SOCKET -1
 #define SOCKET_ERROR -1
@@ -31,621 +70,3296 @@ typedef int socklen_t;
 
 using namespace std;
 
+// HTTP Server Classes
 
-class JAMBAllocation {
-private:
-    int jambScore;
-    double jambPercentage;
-    
+// Scratch memory for one request. Each thread keeps a buffer for its whole
+// life; a request carves its objects out of it with a monotonic arena and
+// they are all dropped at once when the arena goes out of scope, so a
+// request only reaches the shared heap if it outgrows the buffer.
+class RequestArena
+{
 public:
-    JAMBAllocation() : jambScore(0), jambPercentage(0.0) {}
-    
-    void setJambScore(int score) {
-        if (score < 0 || score > 400) {
-            cout << "Invalid JAMB score. Score must be between 0 and 400.\n";
-            return;
+    static const size_t buffer_size = 64 * 1024;
+
+    RequestArena()
+        : borrowed(!buffer_in_use),
+          arena(borrowed ? threadBuffer() : nullptr, borrowed ? buffer_size : 0)
+    {
+        // A nested arena on the same thread starts empty and uses the heap
+        if (borrowed)
+        {
+            buffer_in_use = true;
         }
-        jambScore = score;
-        calculateJambPercentage();
     }
-    
-    void calculateJambPercentage() {
-        jambPercentage = (jambScore / 400.0) * 60.0; // 60% for JAMB
-    }
-    
-    // Getters
-    int getJambScore() const { return jambScore; }
-    double getJambPercentage() const { return jambPercentage; }
-    
-    void displayJambResults() const {
-        cout << "\nJAMB SECTION (60% Weight):\n";
-        cout << "JAMB Score: " << jambScore << "/400\n";
-        cout << "JAMB Percentage: " << fixed << setprecision(1) << jambPercentage << "%\n";
+
+    ~RequestArena()
+    {
+        arena.release();
+        if (borrowed)
+        {
+            buffer_in_use = false;
+        }
     }
-};
 
-class WAECAllocation {
+    RequestArena(const RequestArena &) = delete;
+    RequestArena &operator=(const RequestArena &) = delete;
+
+    pmr::memory_resource *resource() { return &arena; }
+
 private:
-    vector<pair<string, string>> waecGrades;
-    unordered_map<string, int> gradePoints;
-    unordered_map<string, int> requiredSubjects;
-    vector<pair<string, string>> optionalSubjects;
-    double waecPercentage;
-    int totalScore;
-    string facultyName;
-    
-    void initializeGradePoints() {
-        gradePoints = {
-            {"A1", 8}, {"B2", 7}, {"B3", 6}, {"C4", 5},
-            {"C5", 4}, {"C6", 3}, {"D7", 2}, {"E8", 1}, {"F9", 0}
-        };
+    static inline thread_local bool buffer_in_use = false;
+
+    bool borrowed;
+    pmr::monotonic_buffer_resource arena;
+
+    static char *threadBuffer()
+    {
+        thread_local unique_ptr<char[]> buffer(new char[buffer_size]);
+        return buffer.get();
     }
-    
+};
+
+// A parsed request. Every field is a view into the connection's input
+// buffer (or the parser's chunk buffer), valid until that buffer changes.
+class HttpRequest
+{
 public:
-    WAECAllocation() : waecPercentage(0.0), totalScore(0) {
-        initializeGradePoints();
-    }
-    
-    void setRequiredSubjects(int choice) {
-        requiredSubjects.clear();
-        
-        switch (choice) {
-            case 1: // Science/Basic Sciences
-                facultyName = "Science/Basic Sciences";
-                cout << "Required subjects for Science students:\n";
-                requiredSubjects = {
-                    {"Mathematics", 0},
-                    {"English Language", 0},
-                    {"Physics", 0},
-                    {"Chemistry", 0}
-                };
-                break;
-                
-            case 2: // Arts and Humanities
-                facultyName = "Arts and Humanities";
-                cout << "Required subjects for Arts students:\n";
-                requiredSubjects = {
-                    {"English Language", 0},
-                    {"Government", 0},
-                    {"Literature in English", 0},
-                    {"Mathematics", 0}
-                };
-                break;
-                
-            case 3: // Management Sciences
-                facultyName = "Management Sciences";
-                cout << "Required subjects for Management Sciences:\n";
-                requiredSubjects = {
-                    {"English Language", 0},
-                    {"Mathematics", 0},
-                    {"Economics", 0},
-                    {"Commerce", 0}
-                };
-                break;
-                
-            case 4: // Engineering
-                facultyName = "Engineering";
-                cout << "Required subjects for Engineering:\n";
-                requiredSubjects = {
-                    {"Mathematics", 0},
-                    {"English Language", 0},
-                    {"Physics", 0},
-                    {"Chemistry", 0}
-                };
-                break;
-                
-            case 5: // Medicine and Surgery
-                facultyName = "Medicine and Surgery";
-                cout << "Required subjects for Medicine:\n";
-                requiredSubjects = {
-                    {"Mathematics", 0},
-                    {"English Language", 0},
-                    {"Physics", 0},
-                    {"Chemistry", 0},
-                    {"Biology", 0}
-                };
-                break;
-                
-            case 6: // Law
-                facultyName = "Law";
-                cout << "Required subjects for Law:\n";
-                requiredSubjects = {
-                    {"English Language", 0},
-                    {"Mathematics", 0},
-                    {"Government", 0},
-                    {"Literature in English", 0}
-                };
-                break;
-                
-            case 7: // Education
-                facultyName = "Education";
-                cout << "Required subjects for Education:\n";
-                requiredSubjects = {
-                    {"English Language", 0},
-                    {"Mathematics", 0},
-                    {"Government", 0},
-                    {"Economics", 0}
-                };
-                break;
-                
-            case 8: // Agriculture
-                facultyName = "Agriculture";
-                cout << "Required subjects for Agriculture:\n";
-                requiredSubjects = {
-                    {"Mathematics", 0},
-                    {"English Language", 0},
-                    {"Chemistry", 0},
-                    {"Biology", 0}
-                };
-                break;
-                
-            case 9: // Environmental Sciences
-                facultyName = "Environmental Sciences";
-                cout << "Required subjects for Environmental Sciences:\n";
-                requiredSubjects = {
-                    {"Mathematics", 0},
-                    {"English Language", 0},
-                    {"Physics", 0},
-                    {"Geography", 0}
-                };
-                break;
-                
-            case 10: // Social Sciences
-                facultyName = "Social Sciences";
-                cout << "Required subjects for Social Sciences:\n";
-                requiredSubjects = {
-                    {"English Language", 0},
-                    {"Mathematics", 0},
-                    {"Government", 0},
-                    {"Economics", 0}
-                };
-                break;
-                
-            case 11: // Allied Medical Sciences
-                facultyName = "Allied Medical Sciences";
-                cout << "Required subjects for Allied Medical Sciences:\n";
-                requiredSubjects = {
-                    {"English Language", 0},
-                    {"Mathematics", 0},
-                    {"Physics", 0},
-                    {"Chemistry", 0},
-                    {"Biology", 0}
-                };
-                break;
-                
-            default:
-                cout << "Invalid choice!\n";
-                return;
+    struct Header
+    {
+        string_view name;
+        string_view value;
+    };
+
+    static const size_t max_headers = 32;
+
+    string_view method;
+    string_view path;
+    string_view version;
+    Header headers[max_headers];
+    size_t header_count = 0;
+    string_view body;
+
+    static bool equalsIgnoreCase(string_view a, string_view b)
+    {
+        if (a.size() != b.size())
+        {
+            return false;
         }
-        
-        // Display required subjects
-        for (const auto& subject : requiredSubjects) {
-            cout << "- " << subject.first << "\n";
+        for (size_t i = 0; i < a.size(); ++i)
+        {
+            if (tolower(static_cast<unsigned char>(a[i])) != tolower(static_cast<unsigned char>(b[i])))
+            {
+                return false;
+            }
         }
+        return true;
     }
-    
-    void addGrade(const string& subject, const string& grade) {
-        // Validate grade
-        if (gradePoints.find(grade) == gradePoints.end()) {
-            cout << "Invalid grade: " << grade << "\n";
-            return;
+
+    static bool containsIgnoreCase(string_view haystack, string_view needle)
+    {
+        for (size_t i = 0; i + needle.size() <= haystack.size(); ++i)
+        {
+            if (equalsIgnoreCase(haystack.substr(i, needle.size()), needle))
+            {
+                return true;
+            }
         }
-        waecGrades.push_back({subject, grade});
+        return false;
     }
-    
-    void addOptionalSubject(const string& subject, const string& grade) {
-        if (gradePoints.find(grade) == gradePoints.end()) {
-            cout << "Invalid grade: " << grade << "\n";
-            return;
-        }
-        optionalSubjects.push_back({subject, grade});
-    }
-    
-    int getGradePoint(const string& grade) const {
-        auto it = gradePoints.find(grade);
-        return (it != gradePoints.end()) ? it->second : 0;
-    }
-    
-    void calculateWaecAllocation() {
-        // Map for quick lookup of available grades
-        unordered_map<string, string> gradesMap;
-        for (const auto& grade : waecGrades) {
-            gradesMap[grade.first] = grade.second;
-        }
-        
-        // Process required subjects
-        vector<pair<string, int>> requiredScores;
-        for (auto& required : requiredSubjects) {
-            const string& subject = required.first;
-            auto it = gradesMap.find(subject);
-            if (it != gradesMap.end()) {
-                int points = getGradePoint(it->second);
-                required.second = points;
-                requiredScores.push_back({subject, points});
-            } else {
-                cout << "Warning: Grade not found for required subject: " << subject << "\n";
-                required.second = 0;
-                requiredScores.push_back({subject, 0});
-            }
-        }
-        
-        // Process optional subjects and sort by points (descending)
-        vector<pair<string, int>> optionalScores;
-        for (const auto& optional : optionalSubjects) {
-            int points = getGradePoint(optional.second);
-            optionalScores.push_back({optional.first, points});
-        }
-        
-        sort(optionalScores.begin(), optionalScores.end(), 
-             [](const pair<string, int>& a, const pair<string, int>& b) {
-                 return a.second > b.second;
-             });
-        
-        // Calculate total score - different calculation for Medicine (5 subjects required)
-        totalScore = 0;
-        int maxSubjects = (facultyName == "Medicine and Surgery" || facultyName == "Allied Medical Sciences") ? 5 : 4;
-        int maxPoints = (facultyName == "Medicine and Surgery" || facultyName == "Allied Medical Sciences") ? 40 : 32;
-        
-        for (const auto& required : requiredScores) {
-            totalScore += required.second;
-        }
-        
-        // Add best optional subjects if we need more than 4 subjects
-        if (maxSubjects == 5 && !optionalScores.empty()) {
-            // For medicine, we don't need optional since we already have 5 required
-        } else if (maxSubjects == 4 && !optionalScores.empty()) {
-            totalScore += optionalScores[0].second;
-            maxPoints = 40; // 5 subjects total
-        }
-        
-        // Calculate percentage (40% weight for WAEC)
-        waecPercentage = (totalScore / (double)maxPoints) * 40.0;
-    }
-    
-    void displayResults() const {
-        cout << "\nWAEC SECTION (40% Weight) - " << facultyName << ":\n";
-        cout << "=========================\n";
-        
-        cout << "\nRequired Subjects:\n";
-        cout << "------------------\n";
-        for (const auto& required : requiredSubjects) {
-            // Find the grade for this subject
-            string grade = "N/A";
-            for (const auto& gradeEntry : waecGrades) {
-                if (gradeEntry.first == required.first) {
-                    grade = gradeEntry.second;
-                    break;
-                }
-            }
-            cout << required.first << ": " << grade << " (" << required.second << " points)\n";
-        }
-        
-        // Show optional subjects only if we're not doing Medicine/Allied Medical
-        if (facultyName != "Medicine and Surgery" && facultyName != "Allied Medical Sciences") {
-            cout << "\nOptional Subjects (Best Selected):\n";
-            cout << "----------------------------------\n";
-            if (!optionalSubjects.empty()) {
-                // Find the best optional subject
-                int bestScore = 0;
-                string bestSubject = "";
-                string bestGrade = "";
-                
-                for (const auto& optional : optionalSubjects) {
-                    int points = getGradePoint(optional.second);
-                    if (points > bestScore) {
-                        bestScore = points;
-                        bestSubject = optional.first;
-                        bestGrade = optional.second;
-                    }
-                }
-                
-                if (!bestSubject.empty()) {
-                    cout << bestSubject << ": " << bestGrade << " (" << bestScore << " points)\n";
-                }
-            } else {
-                cout << "No optional subjects provided.\n";
+
+    // Header names are case-insensitive; returns an empty view when absent
+    string_view header(string_view name) const
+    {
+        for (size_t i = 0; i < header_count; ++i)
+        {
+            if (equalsIgnoreCase(headers[i].name, name))
+            {
+                return headers[i].value;
             }
         }
-        
-        int maxPossible = (facultyName == "Medicine and Surgery" || facultyName == "Allied Medical Sciences") ? 40 : 40;
-        cout << "\nTotal Score: " << totalScore << "/" << maxPossible << "\n";
-        cout << "WAEC Percentage: " << fixed << setprecision(1) << waecPercentage << "%\n";
-    }
-    
-    // Getters
-    double getPercentage() const { return waecPercentage; }
-    int getTotalScore() const { return totalScore; }
-    string getFacultyName() const { return facultyName; }
-    
-    const unordered_map<string, int>& getRequiredSubjects() const {
-        return requiredSubjects;
+        return {};
     }
-    
-    const vector<pair<string, string>>& getOptionalSubjects() const {
-        return optionalSubjects;
-    }
-};
 
-class LASUScreeningAggregator : public JAMBAllocation, public WAECAllocation {
-private:
-    double finalScreeningScore;
-    
-public:
-    LASUScreeningAggregator() : finalScreeningScore(0.0) {}
-    
-    void calculateScreeningResults() {
-        // Calculate WAEC allocation
-        calculateWaecAllocation();
-        
-        // Calculate final screening score
-        finalScreeningScore = getJambPercentage() + getPercentage();
-        
-        // cout << "\nCalculation Breakdown:\n";
-        // cout << "======================\n";
-        // cout << "JAMB Score: " << getJambScore() << "/400 = " 
-        //      << fixed << setprecision(1) << getJambPercentage() << "%\n";
-        // cout << "WAEC Score: " << getTotalScore() << "/40 = " 
-        //      << fixed << setprecision(1) << getPercentage() << "%\n";
-        // cout << "Final Aggregate: " << getJambPercentage() << "% + " 
-        //      << getPercentage() << "% = " << finalScreeningScore << "%\n";
-    }
-
-    double getFinalScreeningScore()
-    {
-        return finalScreeningScore;
-    }
-    
-    string getAdmissionStatus() {
-        // cout << "\n========================================\n";
-        // cout << "      LASU SCREENING RESULTS\n";
-        // cout << "========================================\n";
-        
-        // // Display JAMB results
-        // displayJambResults();
-        
-        // // Display WAEC results
-        // displayResults();
-        
-        // // Display final aggregate
-        // cout << "\n========================================\n";
-        // cout << "FINAL SCREENING AGGREGATE - " << getFacultyName() << ":\n";
-        // cout << "========================================\n";
-        // cout << "JAMB Contribution: " << fixed << setprecision(1) << getJambPercentage() << "%\n";
-        // cout << "WAEC Contribution: " << fixed << setprecision(1) << getPercentage() << "%\n";
-        // cout << "TOTAL SCREENING SCORE: " << finalScreeningScore << "%\n";
-        
-
-        // Faculty-specific admission guidance
-        // cout << "\nADMISSION PROSPECT FOR " << getFacultyName() << ":\n";
-        double cutoffThreshold = getCutoffThreshold();
-
-
-        if (finalScreeningScore >= cutoffThreshold + 10) {
-             return "EXCELLENT - High chance of admission!";
-        } else if (finalScreeningScore >= cutoffThreshold) {
-            return "GOOD - Moderate chance of admission";
-        } else if (finalScreeningScore >= cutoffThreshold - 10) {
-            return "FAIR - Consider retaking JAMB or improving WAEC";
-        } else {
-             return "POOR - Strong recommendation to retake JAMB";
-        }
-        
-        // cout << "Estimated Cut-off for " << getFacultyName() << ": " << cutoffThreshold << "%\n";
-        // cout << "========================================\n";
-    }
-
-    
-    double getCutoffThreshold() const {
-        // Different faculties have different competition levels
-        string faculty = getFacultyName();
-        if (faculty == "Medicine and Surgery") return 75.0;
-        else if (faculty == "Law") return 70.0;
-        else if (faculty == "Engineering") return 65.0;
-        else if (faculty == "Allied Medical Sciences") return 65.0;
-        else if (faculty == "Management Sciences") return 60.0;
-        else if (faculty == "Social Sciences") return 58.0;
-        else if (faculty == "Science/Basic Sciences") return 60.0;
-        else if (faculty == "Environmental Sciences") return 55.0;
-        else if (faculty == "Agriculture") return 50.0;
-        else if (faculty == "Education") return 45.0;
-        else if (faculty == "Arts and Humanities") return 50.0;
-        else return 55.0; // default
-    }
-    
-    double getFinalScreeningScore() const {
-        return finalScreeningScore;
+    // HTTP/1.1 connections persist unless the client opts out; 1.0 is the reverse
+    bool keepAlive() const
+    {
+        string_view connection = header("Connection");
+        if (version == "HTTP/1.0")
+        {
+            return containsIgnoreCase(connection, "keep-alive");
+        }
+        return !containsIgnoreCase(connection, "close");
     }
 };
 
-// HTTP Server Classes
-class HttpRequest
+// Single-pass, resumable request parser. It walks the input once, line by
+// line, and remembers where it stopped, so a request that trickles in over
+// many reads is never rescanned. Positions are kept as offsets because the
+// buffer may be reallocated between reads; the views in request() are only
+// built once the whole request is there. Apart from decoding chunked
+// bodies (into a buffer reused across requests) it never allocates.
+class HttpRequestParser
 {
 public:
-    string method;
-    string path;
-    string version;
-    unordered_map<string, string> headers;
-    string body;
+    enum class Result
+    {
+        Incomplete,
+        Ready,
+        HeadersTooLarge,
+        BodyTooLarge,
+        Malformed
+    };
+
+    // Views into the buffer passed to the advance() call that returned Ready
+    const HttpRequest &request() const { return parsed; }
+
+    bool headersComplete() const { return stage == Stage::Body; }
+    bool expectsContinue() const { return headersComplete() && expect_continue; }
+
+    // Bytes of input that belong to the request once advance() returned Ready
+    size_t frameLength() const { return frame_length; }
+
+    void reset()
+    {
+        stage = Stage::RequestLine;
+        cursor = 0;
+        header_count = 0;
+        header_length = 0;
+        chunked = false;
+        expect_continue = false;
+        content_length = 0;
+        frame_length = 0;
+        decoded_body.clear();
+        parsed = HttpRequest();
+    }
+
+    // `input` starts at the first byte of the request and only ever grows
+    // between calls until Ready is returned
+    Result advance(string_view input, size_t max_header_bytes, size_t max_body_bytes)
+    {
+        while (stage != Stage::Body)
+        {
+            size_t line_end = input.find('\n', cursor);
+            if (line_end == string_view::npos)
+            {
+                return input.size() > max_header_bytes ? Result::HeadersTooLarge : Result::Incomplete;
+            }
+            if (line_end + 1 > max_header_bytes)
+            {
+                return Result::HeadersTooLarge;
+            }
+
+            Span line{cursor, line_end - cursor};
+            if (line.length > 0 && input[line_end - 1] == '\r')
+            {
+                --line.length;
+            }
+            cursor = line_end + 1;
+
+            Result result = stage == Stage::RequestLine ? parseRequestLine(input, line)
+                                                        : parseHeaderLine(input, line, max_body_bytes);
+            if (result != Result::Incomplete)
+            {
+                return result;
+            }
+        }
+
+        if (chunked)
+        {
+            return decodeChunks(input, max_body_bytes);
+        }
+
+        if (input.size() - header_length < content_length)
+        {
+            return Result::Incomplete;
+        }
+        frame_length = header_length + content_length;
+        return finish(input, input.substr(header_length, content_length));
+    }
+
+private:
+    enum class Stage
+    {
+        RequestLine,
+        Headers,
+        Body
+    };
+
+    struct Span
+    {
+        size_t offset;
+        size_t length;
+
+        string_view in(string_view input) const { return input.substr(offset, length); }
+    };
 
-    static HttpRequest parse(const string &raw_request)
+    Stage stage = Stage::RequestLine;
+    size_t cursor = 0; // start of the first unparsed line, or of the next chunk
+    Span method{0, 0};
+    Span path{0, 0};
+    Span version{0, 0};
+    Span header_names[HttpRequest::max_headers];
+    Span header_values[HttpRequest::max_headers];
+    size_t header_count = 0;
+    size_t header_length = 0;
+    bool chunked = false;
+    bool expect_continue = false;
+    size_t content_length = 0;
+    size_t frame_length = 0;
+    string decoded_body;
+    HttpRequest parsed;
+
+    Result parseRequestLine(string_view input, Span line)
+    {
+        // Tolerate stray blank lines between pipelined requests
+        if (line.length == 0)
+        {
+            return Result::Incomplete;
+        }
+
+        string_view text = line.in(input);
+        size_t first_space = text.find(' ');
+        size_t last_space = text.rfind(' ');
+        if (first_space == 0 || first_space == string_view::npos || last_space == first_space)
+        {
+            return Result::Malformed;
+        }
+
+        method = {line.offset, first_space};
+        path = {line.offset + first_space + 1, last_space - first_space - 1};
+        version = {line.offset + last_space + 1, line.length - last_space - 1};
+        if (path.length == 0 || version.in(input).substr(0, 5) != "HTTP/")
+        {
+            return Result::Malformed;
+        }
+
+        stage = Stage::Headers;
+        return Result::Incomplete;
+    }
+
+    Result parseHeaderLine(string_view input, Span line, size_t max_body_bytes)
     {
-        HttpRequest request;
-        istringstream stream(raw_request);
-        string line;
+        if (line.length == 0)
+        {
+            header_length = cursor;
+            stage = Stage::Body;
+            return checkFraming(input, max_body_bytes);
+        }
+
+        string_view text = line.in(input);
+        size_t colon = text.find(':');
+        if (colon == 0 || colon == string_view::npos || text[0] == ' ' || text[0] == '\t' ||
+            text[colon - 1] == ' ' || text[colon - 1] == '\t')
+        {
+            return Result::Malformed;
+        }
+        if (header_count == HttpRequest::max_headers)
+        {
+            return Result::HeadersTooLarge;
+        }
 
-        // Parse request line
-        if (getline(stream, line))
+        size_t value_start = colon + 1;
+        size_t value_end = text.size();
+        while (value_start < value_end && (text[value_start] == ' ' || text[value_start] == '\t'))
         {
-            istringstream line_stream(line);
-            line_stream >> request.method >> request.path >> request.version;
+            ++value_start;
         }
+        while (value_end > value_start && (text[value_end - 1] == ' ' || text[value_end - 1] == '\t'))
+        {
+            --value_end;
+        }
+
+        header_names[header_count] = {line.offset, colon};
+        header_values[header_count] = {line.offset + value_start, value_end - value_start};
+        ++header_count;
+        return Result::Incomplete;
+    }
 
-        // Parse headers
-        while (getline(stream, line) && !line.empty() && line != "\r")
+    string_view headerValue(string_view input, string_view name) const
+    {
+        for (size_t i = 0; i < header_count; ++i)
         {
-            size_t colon_pos = line.find(':');
-            if (colon_pos != string::npos)
+            if (HttpRequest::equalsIgnoreCase(header_names[i].in(input), name))
             {
-                string key = line.substr(0, colon_pos);
-                string value = line.substr(colon_pos + 1);
+                return header_values[i].in(input);
+            }
+        }
+        return {};
+    }
 
-                // Trim whitespace
-                value.erase(0, value.find_first_not_of(" \t"));
-                value.erase(value.find_last_not_of(" \t\r\n") + 1);
+    Result checkFraming(string_view input, size_t max_body_bytes)
+    {
+        string_view length_value = headerValue(input, "Content-Length");
+        chunked = HttpRequest::containsIgnoreCase(headerValue(input, "Transfer-Encoding"), "chunked");
+        expect_continue = HttpRequest::containsIgnoreCase(headerValue(input, "Expect"), "100-continue");
+        cursor = header_length;
+
+        if (chunked)
+        {
+            // Both framings at once is a request smuggling vector
+            return length_value.empty() ? Result::Incomplete : Result::Malformed;
+        }
 
-                request.headers[key] = value;
+        if (length_value.empty())
+        {
+            return Result::Incomplete;
+        }
+        if (length_value.size() > 18)
+        {
+            return Result::Malformed;
+        }
+        for (char c : length_value)
+        {
+            if (c < '0' || c > '9')
+            {
+                return Result::Malformed;
             }
+            content_length = content_length * 10 + static_cast<size_t>(c - '0');
         }
 
-        // Parse body (if any)
-        string body_line;
-        while (getline(stream, body_line))
+        // Rejected from the headers alone, before any body is read
+        return content_length > max_body_bytes ? Result::BodyTooLarge : Result::Incomplete;
+    }
+
+    Result decodeChunks(string_view input, size_t max_body_bytes)
+    {
+        while (true)
         {
-            request.body += body_line + "\n";
+            size_t line_end = input.find("\r\n", cursor);
+            if (line_end == string_view::npos)
+            {
+                return input.size() - cursor > 1024 ? Result::Malformed : Result::Incomplete;
+            }
+
+            size_t chunk_size = 0;
+            size_t digits = 0;
+            for (size_t i = cursor; i < line_end && isxdigit(static_cast<unsigned char>(input[i])); ++i)
+            {
+                if (++digits > 15)
+                {
+                    return Result::Malformed;
+                }
+                char c = static_cast<char>(tolower(static_cast<unsigned char>(input[i])));
+                chunk_size = chunk_size * 16 + static_cast<size_t>(c <= '9' ? c - '0' : c - 'a' + 10);
+            }
+            if (digits == 0)
+            {
+                return Result::Malformed;
+            }
+
+            if (chunk_size == 0)
+            {
+                // Last chunk; skip any trailer fields up to the blank line
+                size_t trailer_end = input.find("\r\n\r\n", line_end);
+                if (trailer_end == string_view::npos)
+                {
+                    return Result::Incomplete;
+                }
+                frame_length = trailer_end + 4;
+                return finish(input, decoded_body);
+            }
+
+            if (decoded_body.size() + chunk_size > max_body_bytes)
+            {
+                return Result::BodyTooLarge;
+            }
+
+            size_t data_start = line_end + 2;
+            if (input.size() < data_start + chunk_size + 2)
+            {
+                return Result::Incomplete;
+            }
+            if (input.substr(data_start + chunk_size, 2) != "\r\n")
+            {
+                return Result::Malformed;
+            }
+
+            decoded_body.append(input.data() + data_start, chunk_size);
+            cursor = data_start + chunk_size + 2;
         }
+    }
 
-        return request;
+    Result finish(string_view input, string_view body)
+    {
+        parsed.method = method.in(input);
+        parsed.path = path.in(input);
+        parsed.version = version.in(input);
+        for (size_t i = 0; i < header_count; ++i)
+        {
+            parsed.headers[i] = {header_names[i].in(input), header_values[i].in(input)};
+        }
+        parsed.header_count = header_count;
+        parsed.body = body;
+        return Result::Ready;
     }
 };
 
-class HttpResponse
+// A complete response rendered once at startup. Both head variants
+// already carry their Connection header, so serving it is just queueing
+// one head, the Date line with the blank line after it, and the shared
+// body straight from this memory.
+struct PrebuiltResponse
 {
-public:
-    int status_code;
-    string status_text;
-    unordered_map<string, string> headers;
+    int status_code = 200;
+    string keep_alive_head;
+    string close_head;
     string body;
+};
 
-    HttpResponse(int code = 200, const string &text = "OK")
-        : status_code(code), status_text(text)
+// One representation of a cacheable resource: its strong validator and
+// the prebuilt 200 and 304 responses for it
+struct StaticVariant
+{
+    string etag;
+    PrebuiltResponse ok;
+    PrebuiltResponse not_modified;
+};
+
+// FNV-1a over the exact bytes sent, so every encoding gets its own tag
+static string strongETag(string_view bytes)
+{
+    uint64_t hash = 14695981039346656037ULL;
+    for (unsigned char c : bytes)
+    {
+        hash ^= c;
+        hash *= 1099511628211ULL;
+    }
+
+    static const char digits[] = "0123456789abcdef";
+    string etag = "\"";
+    for (int shift = 60; shift >= 0; shift -= 4)
     {
-        headers["Content-Type"] = "text/html";
-        headers["Server"] = "LASU-Screening-Server/1.0";
-        headers["Connection"] = "close";
-        headers["Access-Control-Allow-Origin"] = "*";
-        headers["Access-Control-Allow-Methods"] = "GET, POST, OPTIONS";
-        headers["Access-Control-Allow-Headers"] = "Content-Type";
+        etag += digits[(hash >> shift) & 0xF];
     }
+    etag += '"';
+    return etag;
+}
 
-    string toString() const
+// If-None-Match uses the weak comparison: W/ prefixes are ignored
+static bool etagMatches(string_view if_none_match, string_view etag)
+{
+    while (!if_none_match.empty())
     {
-        string response = "HTTP/1.1 " + to_string(status_code) + " " + status_text + "\r\n";
+        size_t comma = if_none_match.find(',');
+        string_view candidate = if_none_match.substr(0, comma);
+        if_none_match = comma == string_view::npos ? string_view() : if_none_match.substr(comma + 1);
 
-        auto headers_copy = headers;
-        headers_copy["Content-Length"] = to_string(body.length());
+        while (!candidate.empty() && (candidate.front() == ' ' || candidate.front() == '\t'))
+            candidate.remove_prefix(1);
+        while (!candidate.empty() && (candidate.back() == ' ' || candidate.back() == '\t'))
+            candidate.remove_suffix(1);
+        if (candidate.substr(0, 2) == "W/")
+            candidate.remove_prefix(2);
 
-        for (const auto &header : headers_copy)
+        if (candidate == "*" || candidate == etag)
         {
-            response += header.first + ": " + header.second + "\r\n";
+            return true;
         }
-
-        response += "\r\n" + body;
-        return response;
     }
+    return false;
+}
+
+enum class ContentEncoding
+{
+    Identity,
+    Gzip,
+    Brotli
 };
 
-class LASUHttpServer
+// Picks the preferred encoding from an Accept-Encoding header, honouring
+// q-values (q=0 excludes); ties go to brotli, then gzip, then identity
+static ContentEncoding negotiateEncoding(string_view accept_encoding)
 {
-private:
-    SOCKET server_socket;
-    int port;
-    bool running;
+    double gzip_q = 0.0;
+    double brotli_q = 0.0;
+    double wildcard_q = -1.0;
+    bool gzip_listed = false;
+    bool brotli_listed = false;
 
-public:
-    LASUHttpServer(int server_port) : port(server_port), running(false)
+    while (!accept_encoding.empty())
     {
+        size_t comma = accept_encoding.find(',');
+        string_view item = accept_encoding.substr(0, comma);
+        accept_encoding = comma == string_view::npos ? string_view() : accept_encoding.substr(comma + 1);
 
-#ifdef _WIN32
-        WSADATA wsaData;
-        if (WSAStartup(MAKEWORD(2, 2), &wsaData) != 0)
+        size_t semicolon = item.find(';');
+        string_view token = item.substr(0, semicolon);
+        while (!token.empty() && (token.front() == ' ' || token.front() == '\t'))
+            token.remove_prefix(1);
+        while (!token.empty() && (token.back() == ' ' || token.back() == '\t'))
+            token.remove_suffix(1);
+
+        double q = 1.0;
+        if (semicolon != string_view::npos)
         {
-            throw runtime_error("WSAStartup failed");
+            string_view params = item.substr(semicolon + 1);
+            size_t q_pos = params.find("q=");
+            if (q_pos != string_view::npos)
+            {
+                q = atof(string(params.substr(q_pos + 2, 5)).c_str());
+            }
         }
-#endif
 
-        server_socket = socket(AF_INET, SOCK_STREAM, 0);
-        if (server_socket == INVALID_SOCKET)
+        if (token == "br")
         {
-            throw runtime_error("Failed to create socket");
+            brotli_q = q;
+            brotli_listed = true;
+        }
+        else if (token == "gzip" || token == "x-gzip")
+        {
+            gzip_q = q;
+            gzip_listed = true;
+        }
+        else if (token == "*")
+        {
+            wildcard_q = q;
         }
+    }
 
-        // Set socket options
-        int opt = 1;
-        setsockopt(server_socket, SOL_SOCKET, SO_REUSEADDR,
-                   reinterpret_cast<const char *>(&opt), sizeof(opt));
+    if (!brotli_listed && wildcard_q >= 0)
+        brotli_q = wildcard_q;
+    if (!gzip_listed && wildcard_q >= 0)
+        gzip_q = wildcard_q;
+
+#ifndef LASU_HAVE_BROTLI
+    brotli_q = 0.0;
+#endif
+#ifndef LASU_HAVE_ZLIB
+    gzip_q = 0.0;
+#endif
+
+    if (brotli_q > 0 && brotli_q >= gzip_q)
+        return ContentEncoding::Brotli;
+    if (gzip_q > 0)
+        return ContentEncoding::Gzip;
+    return ContentEncoding::Identity;
+}
+
+#ifdef LASU_HAVE_ZLIB
+static string gzipCompress(string_view data)
+{
+    z_stream stream{};
+    // windowBits 15 + 16 selects the gzip wrapper
+    if (deflateInit2(&stream, Z_BEST_COMPRESSION, Z_DEFLATED, 15 + 16, 9, Z_DEFAULT_STRATEGY) != Z_OK)
+    {
+        throw runtime_error("deflateInit2 failed");
     }
 
-    ~LASUHttpServer()
+    string compressed(deflateBound(&stream, data.size()), '\0');
+    stream.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(data.data()));
+    stream.avail_in = static_cast<uInt>(data.size());
+    stream.next_out = reinterpret_cast<Bytef *>(&compressed[0]);
+    stream.avail_out = static_cast<uInt>(compressed.size());
+
+    int result = deflate(&stream, Z_FINISH);
+    deflateEnd(&stream);
+    if (result != Z_STREAM_END)
     {
-        stop();
-        closesocket(server_socket);
+        throw runtime_error("gzip compression failed");
+    }
+    compressed.resize(stream.total_out);
+    return compressed;
+}
+#endif
+
+#ifdef LASU_HAVE_BROTLI
+static string brotliCompress(string_view data)
+{
+    size_t size = BrotliEncoderMaxCompressedSize(data.size());
+    string compressed(size, '\0');
+    if (!BrotliEncoderCompress(BROTLI_MAX_QUALITY, BROTLI_DEFAULT_WINDOW, BROTLI_MODE_TEXT,
+                               data.size(), reinterpret_cast<const uint8_t *>(data.data()),
+                               &size, reinterpret_cast<uint8_t *>(&compressed[0])))
+    {
+        throw runtime_error("brotli compression failed");
+    }
+    compressed.resize(size);
+    return compressed;
+}
+#endif
+
+// "Date: <IMF-fixdate>\r\n" for the current second. Each thread keeps its
+// own copy and re-renders it when the second changes, so the per-response
+// cost is one clock read.
+inline string_view httpDateLine()
+{
+    thread_local time_t rendered_second = -1;
+    thread_local char line[64];
+    thread_local size_t length = 0;
+
+    time_t now = time(nullptr);
+    if (now != rendered_second)
+    {
+        tm parts;
 #ifdef _WIN32
-        WSACleanup();
+        gmtime_s(&parts, &now);
+#else
+        gmtime_r(&now, &parts);
 #endif
+        length = strftime(line, sizeof(line), "Date: %a, %d %b %Y %H:%M:%S GMT\r\n", &parts);
+        rendered_second = now;
     }
+    return string_view(line, length);
+}
 
-    void start()
+// A response body still being produced when the head goes out; the
+// server knows the concrete kind and feeds it to the connection piece by
+// piece
+struct ResponseStream
+{
+    virtual ~ResponseStream() = default;
+};
+
+// A response on its way out. Headers every response carries are one
+// pre-serialized block; the few that vary live inline, so building a
+// response allocates nothing beyond the body.
+class HttpResponse
+{
+public:
+    struct Header
     {
-        sockaddr_in server_addr{};
-        server_addr.sin_family = AF_INET;
+        string_view name; // always a literal
+        string value;
+    };
+    static const size_t max_headers = 6;
+
+    int status_code;
+    string_view status_text;
+    string_view content_type = "text/html"; // empty for none (304)
+    string body;
+
+    // Set for responses rendered at startup; sent as-is and the fields
+    // above are ignored
+    const PrebuiltResponse *prebuilt = nullptr;
+
+    // Set when the body follows the head as it is produced: in chunked
+    // encoding, or for HTTP/1.0 until the connection closes
+    shared_ptr<ResponseStream> stream;
+    bool chunked = false;
+
+    HttpResponse(int code = 200, string_view text = "OK")
+        : status_code(code), status_text(text)
+    {
+    }
+
+    void addHeader(string_view name, string value)
+    {
+        if (header_count == max_headers)
+        {
+            throw logic_error("Too many response headers");
+        }
+        headers[header_count++] = {name, move(value)};
+    }
+
+    // Appends the status line and headers, ending with `connection_headers`.
+    // The Date line and the blank line are left to the caller, so prebuilt
+    // heads stay valid forever.
+    void appendHead(string &out, string_view connection_headers) const
+    {
+        char digits[24];
+        out.append("HTTP/1.1 ");
+        out.append(digits, to_chars(digits, digits + sizeof(digits), status_code).ptr);
+        out += ' ';
+        out.append(status_text);
+        out.append("\r\n");
+        out.append(common_headers);
+
+        if (!content_type.empty())
+        {
+            out.append("Content-Type: ");
+            out.append(content_type);
+            out.append("\r\n");
+        }
+        for (size_t i = 0; i < header_count; ++i)
+        {
+            out.append(headers[i].name);
+            out.append(": ");
+            out.append(headers[i].value);
+            out.append("\r\n");
+        }
+        if (stream)
+        {
+            if (chunked)
+            {
+                out.append("Transfer-Encoding: chunked\r\n");
+            }
+        }
+        else if (status_code != 204 && status_code != 304)
+        {
+            out.append("Content-Length: ");
+            out.append(digits, to_chars(digits, digits + sizeof(digits), body.size()).ptr);
+            out.append("\r\n");
+        }
+        out.append(connection_headers);
+    }
+
+private:
+    static constexpr string_view common_headers =
+        "Server: LASU-Screening-Server/1.0\r\n"
+        "Access-Control-Allow-Origin: *\r\n"
+        "Access-Control-Allow-Methods: GET, POST, OPTIONS\r\n"
+        "Access-Control-Allow-Headers: Content-Type\r\n";
+
+    Header headers[max_headers];
+    size_t header_count = 0;
+};
+
+// Bounded multi-producer/multi-consumer ring buffer (Vyukov). Every slot
+// carries a sequence number, so producers and consumers only ever contend
+// on their own cursor and never take a lock.
+template <typename T>
+class MpmcRing
+{
+private:
+    struct alignas(64) Cell
+    {
+        atomic<size_t> sequence;
+        T value;
+    };
+
+    const size_t mask;
+    unique_ptr<Cell[]> cells;
+    alignas(64) atomic<size_t> enqueue_pos;
+    alignas(64) atomic<size_t> dequeue_pos;
+
+public:
+    explicit MpmcRing(size_t capacity)
+        : mask(capacity - 1), cells(new Cell[capacity]), enqueue_pos(0), dequeue_pos(0)
+    {
+        if (capacity < 2 || (capacity & (capacity - 1)) != 0)
+        {
+            throw invalid_argument("Ring capacity must be a power of two");
+        }
+        for (size_t i = 0; i < capacity; ++i)
+        {
+            cells[i].sequence.store(i, memory_order_relaxed);
+        }
+    }
+
+    bool tryPush(const T &value)
+    {
+        size_t pos = enqueue_pos.load(memory_order_relaxed);
+        while (true)
+        {
+            Cell &cell = cells[pos & mask];
+            size_t sequence = cell.sequence.load(memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+
+            if (diff == 0)
+            {
+                if (enqueue_pos.compare_exchange_weak(pos, pos + 1, memory_order_relaxed))
+                {
+                    cell.value = value;
+                    cell.sequence.store(pos + 1, memory_order_release);
+                    return true;
+                }
+            }
+            else if (diff < 0)
+            {
+                return false; // full
+            }
+            else
+            {
+                pos = enqueue_pos.load(memory_order_relaxed);
+            }
+        }
+    }
+
+    bool tryPop(T &value)
+    {
+        size_t pos = dequeue_pos.load(memory_order_relaxed);
+        while (true)
+        {
+            Cell &cell = cells[pos & mask];
+            size_t sequence = cell.sequence.load(memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos + 1);
+
+            if (diff == 0)
+            {
+                if (dequeue_pos.compare_exchange_weak(pos, pos + 1, memory_order_relaxed))
+                {
+                    value = move(cell.value);
+                    cell.sequence.store(pos + mask + 1, memory_order_release);
+                    return true;
+                }
+            }
+            else if (diff < 0)
+            {
+                return false; // empty
+            }
+            else
+            {
+                pos = dequeue_pos.load(memory_order_relaxed);
+            }
+        }
+    }
+
+    // Approximate while other threads are pushing or popping
+    size_t size() const
+    {
+        size_t head = dequeue_pos.load(memory_order_relaxed);
+        size_t tail = enqueue_pos.load(memory_order_relaxed);
+        return tail > head ? tail - head : 0;
+    }
+
+    size_t capacity() const { return mask + 1; }
+};
+
+// Fixed set of worker threads fed through an MpmcRing. submit() never
+// spawns anything: when the ring is full the caller waits, which in turn
+// stops it from pulling more work off the network.
+template <typename Job>
+class WorkerPool
+{
+public:
+    struct Stats
+    {
+        size_t workers;
+        size_t busy_workers;
+        size_t queue_depth;
+        size_t queue_capacity;
+        uint64_t jobs_completed;
+        uint64_t backpressure_waits;
+        uint64_t wakeups; // parked workers woken by submit()
+        double utilisation; // busy time / (workers * uptime)
+    };
+
+private:
+    MpmcRing<Job> queue;
+    function<void(Job &)> handler;
+    vector<thread> workers;
+
+    mutex park_mutex;
+    condition_variable park_cv;
+    atomic<size_t> parked_workers;
+    atomic<bool> stopping;
+
+    atomic<size_t> busy_workers;
+    atomic<uint64_t> busy_nanoseconds;
+    atomic<uint64_t> jobs_completed;
+    atomic<uint64_t> backpressure_waits;
+    atomic<uint64_t> wakeups;
+    chrono::steady_clock::time_point started_at;
+
+    void workerLoop()
+    {
+        Job job;
+        while (true)
+        {
+            if (queue.tryPop(job))
+            {
+                auto begin = chrono::steady_clock::now();
+                busy_workers.fetch_add(1, memory_order_relaxed);
+
+                handler(job);
+
+                busy_workers.fetch_sub(1, memory_order_relaxed);
+                auto elapsed = chrono::duration_cast<chrono::nanoseconds>(
+                    chrono::steady_clock::now() - begin);
+                busy_nanoseconds.fetch_add(static_cast<uint64_t>(elapsed.count()),
+                                           memory_order_relaxed);
+                jobs_completed.fetch_add(1, memory_order_relaxed);
+                job = Job(); // let go of anything the job holds
+                continue;
+            }
+
+            if (stopping.load(memory_order_acquire))
+            {
+                return;
+            }
+
+            unique_lock<mutex> lock(park_mutex);
+            parked_workers.fetch_add(1);
+            atomic_thread_fence(memory_order_seq_cst);
+            park_cv.wait_for(lock, chrono::milliseconds(100), [this]
+                             { return queue.size() > 0 || stopping.load(); });
+            parked_workers.fetch_sub(1);
+        }
+    }
+
+    void wakeWorker()
+    {
+        atomic_thread_fence(memory_order_seq_cst);
+        if (parked_workers.load() > 0)
+        {
+            wakeups.fetch_add(1, memory_order_relaxed);
+            lock_guard<mutex> lock(park_mutex);
+            park_cv.notify_one();
+        }
+    }
+
+public:
+    WorkerPool(size_t worker_count, size_t queue_capacity, function<void(Job &)> job_handler)
+        : queue(queue_capacity), handler(move(job_handler)), parked_workers(0),
+          stopping(false), busy_workers(0), busy_nanoseconds(0), jobs_completed(0),
+          backpressure_waits(0), wakeups(0), started_at(chrono::steady_clock::now())
+    {
+        for (size_t i = 0; i < max<size_t>(worker_count, 1); ++i)
+        {
+            workers.emplace_back(&WorkerPool::workerLoop, this);
+        }
+    }
+
+    ~WorkerPool()
+    {
+        shutdown();
+    }
+
+    WorkerPool(const WorkerPool &) = delete;
+    WorkerPool &operator=(const WorkerPool &) = delete;
+
+    void submit(const Job &job)
+    {
+        if (!queue.tryPush(job))
+        {
+            backpressure_waits.fetch_add(1, memory_order_relaxed);
+            while (!queue.tryPush(job))
+            {
+                this_thread::yield();
+            }
+        }
+
+        wakeWorker();
+    }
+
+    // Like submit() but never waits: false if the queue is full
+    bool trySubmit(const Job &job)
+    {
+        if (!queue.tryPush(job))
+        {
+            return false;
+        }
+        wakeWorker();
+        return true;
+    }
+
+    // Lets the workers finish everything already queued, then joins them
+    void shutdown()
+    {
+        stopping.store(true, memory_order_release);
+        {
+            lock_guard<mutex> lock(park_mutex);
+            park_cv.notify_all();
+        }
+        for (auto &worker : workers)
+        {
+            if (worker.joinable())
+            {
+                worker.join();
+            }
+        }
+    }
+
+    Stats stats() const
+    {
+        Stats s{};
+        s.workers = workers.size();
+        s.busy_workers = busy_workers.load(memory_order_relaxed);
+        s.queue_depth = queue.size();
+        s.queue_capacity = queue.capacity();
+        s.jobs_completed = jobs_completed.load(memory_order_relaxed);
+        s.backpressure_waits = backpressure_waits.load(memory_order_relaxed);
+        s.wakeups = wakeups.load(memory_order_relaxed);
+
+        double uptime = chrono::duration<double, nano>(chrono::steady_clock::now() - started_at).count();
+        double busy = static_cast<double>(busy_nanoseconds.load(memory_order_relaxed));
+        s.utilisation = uptime > 0 ? busy / (uptime * s.workers) : 0.0;
+        return s;
+    }
+};
+
+// Structured log kept off the request path. A caller renders one JSON line
+// into a fixed-size record and pushes it onto an MpmcRing without taking a
+// lock; a background thread drains the ring and writes each batch with a
+// single call. When the ring is full the record is dropped and counted
+// rather than making a request wait for the disk.
+class AsyncLogger
+{
+public:
+    using Field = pair<string_view, string_view>;
+
+    static const size_t ring_capacity = 2048;
+    static const size_t max_value_bytes = 200; // longer strings are cut
+    static const int flush_interval_ms = 50;
+
+    // An empty path logs to stderr. Access records are kept for every
+    // `access_sample_every`-th request per thread; 0 turns them off.
+    AsyncLogger(const string &path, unsigned access_sample_every)
+        : ring(ring_capacity), sample_every(access_sample_every), stopping(false), dropped(0)
+    {
+        out = path.empty() ? stderr : fopen(path.c_str(), "a");
+        if (!out)
+        {
+            throw runtime_error("Cannot open log file " + path);
+        }
+        writer = thread(&AsyncLogger::writerLoop, this);
+    }
+
+    ~AsyncLogger()
+    {
+        stopping.store(true, memory_order_release);
+        writer.join();
+        if (out != stderr)
+        {
+            fclose(out);
+        }
+    }
+
+    AsyncLogger(const AsyncLogger &) = delete;
+    AsyncLogger &operator=(const AsyncLogger &) = delete;
+
+    // {"ts":..,"level":"warn","event":"invalid_grade","grade":"Z9"}; at most
+    // three fields fit
+    void event(string_view level, string_view name, initializer_list<Field> fields = {})
+    {
+        Record record;
+        LineBuilder line(record);
+        line.begin();
+        line.field("level", level);
+        line.field("event", name);
+        for (const Field &field : fields)
+        {
+            line.field(field.first, field.second);
+        }
+        submit(line);
+    }
+
+    // True for every Nth request on the calling thread
+    bool sampleAccess()
+    {
+        if (sample_every == 0)
+        {
+            return false;
+        }
+        thread_local uint64_t seen = 0;
+        return ++seen % sample_every == 0;
+    }
+
+    void access(string_view method, string_view path, int status, size_t bytes, int64_t micros)
+    {
+        Record record;
+        LineBuilder line(record);
+        line.begin();
+        line.field("type", "access");
+        line.field("method", method);
+        line.field("path", path);
+        line.field("status", status);
+        line.field("bytes", static_cast<int64_t>(bytes));
+        line.field("us", micros);
+        submit(line);
+    }
+
+private:
+    struct Record
+    {
+        uint32_t length = 0;
+        char text[1020];
+    };
+
+    // Appends JSON to a record; anything that does not fit marks the line
+    // as overflowed instead of leaving it half-written
+    class LineBuilder
+    {
+    public:
+        explicit LineBuilder(Record &target) : record(target) {}
+
+        void begin()
+        {
+            raw("{\"ts\":");
+            number(chrono::duration_cast<chrono::milliseconds>(
+                       chrono::system_clock::now().time_since_epoch()).count());
+        }
+
+        void field(string_view key, string_view value)
+        {
+            raw(",\"");
+            raw(key);
+            raw("\":\"");
+            escaped(value.substr(0, max_value_bytes));
+            raw("\"");
+        }
+
+        void field(string_view key, int64_t value)
+        {
+            raw(",\"");
+            raw(key);
+            raw("\":");
+            number(value);
+        }
+
+        // Closes the object; false if the line overflowed
+        bool finish()
+        {
+            raw("}");
+            return !overflowed;
+        }
+
+        const Record &result() const { return record; }
+
+    private:
+        Record &record;
+        bool overflowed = false;
+
+        void raw(string_view text)
+        {
+            if (record.length + text.size() > sizeof(record.text))
+            {
+                overflowed = true;
+                return;
+            }
+            memcpy(record.text + record.length, text.data(), text.size());
+            record.length += static_cast<uint32_t>(text.size());
+        }
+
+        void number(int64_t value)
+        {
+            char digits[24];
+            raw(string_view(digits, static_cast<size_t>(to_chars(digits, digits + sizeof(digits), value).ptr - digits)));
+        }
+
+        void escaped(string_view text)
+        {
+            emitJsonEscaped(text, [this](string_view piece)
+                            { raw(piece); });
+        }
+    };
+
+    MpmcRing<Record> ring;
+    unsigned sample_every;
+    FILE *out;
+    thread writer;
+    atomic<bool> stopping;
+    atomic<uint64_t> dropped;
+
+    void submit(LineBuilder &line)
+    {
+        if (!line.finish() || !ring.tryPush(line.result()))
+        {
+            dropped.fetch_add(1, memory_order_relaxed);
+        }
+    }
+
+    void writerLoop()
+    {
+        string batch;
+        Record record;
+        while (true)
+        {
+            bool stop = stopping.load(memory_order_acquire);
+            while (batch.size() < 256 * 1024 && ring.tryPop(record))
+            {
+                batch.append(record.text, record.length);
+                batch += '\n';
+            }
+
+            uint64_t lost = dropped.exchange(0, memory_order_relaxed);
+            if (lost > 0)
+            {
+                LineBuilder line(record);
+                record.length = 0;
+                line.begin();
+                line.field("level", "warn");
+                line.field("event", "log_records_dropped");
+                line.field("count", static_cast<int64_t>(lost));
+                line.finish();
+                batch.append(record.text, record.length);
+                batch += '\n';
+            }
+
+            if (!batch.empty())
+            {
+                fwrite(batch.data(), 1, batch.size(), out);
+                fflush(out);
+                batch.clear();
+                continue;
+            }
+            if (stop)
+            {
+                return;
+            }
+            this_thread::sleep_for(chrono::milliseconds(flush_interval_ms));
+        }
+    }
+};
+
+enum class NetworkBackend
+{
+    Epoll,   // readiness loops feeding the worker pool
+    IoUring, // completion rings, requests handled on the loop threads
+};
+
+struct ServerOptions
+{
+    int idle_timeout_seconds = 15;
+    int max_requests_per_connection = 100;
+
+    // Requests past these sizes are answered with 431 / 413 and the
+    // connection is closed without reading the rest
+    size_t max_header_bytes = 16 * 1024;
+    size_t max_body_bytes = 8 * 1024 * 1024;
+
+    // Pipelined requests are parsed ahead only while less than this much
+    // response data is waiting to be written
+    size_t max_pending_output = 1 << 20;
+
+    // Output at least this large is written under TCP_CORK so it leaves in
+    // full segments (Linux); everything else goes straight out, since
+    // sockets run with TCP_NODELAY for the small JSON replies
+    size_t cork_threshold = 64 * 1024;
+
+    // Cache-Control max-age for the homepage and for /api/subjects; both
+    // also carry strong ETags, so expired copies revalidate with a 304
+    int page_max_age_seconds = 300;
+    int catalog_max_age_seconds = 86400;
+
+    // On shutdown, how long in-flight requests get to finish before the
+    // remaining connections are cut
+    int drain_timeout_seconds = 10;
+
+    // Pending-connection queue per listening socket (the kernel caps it at
+    // net.core.somaxconn)
+    int listen_backlog = 1024;
+
+    // Event loops, each pinned to a core and accepting on its own
+    // SO_REUSEPORT listener (Linux only; 0 means one per core)
+    unsigned event_loops = 0;
+
+    // Networking backend for the event loops (Linux only). io_uring falls
+    // back to epoll when the kernel cannot provide it.
+    NetworkBackend backend = NetworkBackend::Epoll;
+
+    // Unix socket used for zero-downtime upgrades (Linux only; empty
+    // disables). A new process started with the same path takes over the
+    // listening sockets from the running one, which then drains and exits.
+    string handoff_socket_path;
+
+    // Candidates accepted in one POST /api/calculate/batch; larger batches
+    // are refused with 413
+    size_t max_batch_candidates = 100000;
+
+    // JSON-lines log for diagnostics and sampled access records (empty
+    // means stderr), and how many requests per access record (0: none)
+    string log_path;
+    unsigned access_log_sample = 0;
+
+    // Candidate CSV (the lasu_bulk_score format, with an id column) scored
+    // at startup to fill the merit lists; none if empty
+    string cohort_path;
+
+    // Length of the per-faculty merit lists served by GET /api/merit, and
+    // how many cohort candidates they may hold; a larger cohort is refused
+    size_t merit_list_size = 100;
+    size_t max_merit_candidates = 5000000;
+
+    // Most candidates in one page of a full merit list (&full=1); also the
+    // page length when the request gives no limit
+    size_t max_merit_page = 1000;
+
+    // Admission places per course category (index 0 unused; 0 means no
+    // quota). Each faculty with a quota has its cutoff set at startup to
+    // the score that fills it from the cohort.
+    vector<size_t> quotas;
+};
+
+class LASUHttpServer
+{
+private:
+    // A queued piece of output: either bytes the connection owns, or a view
+    // of memory that outlives it (prebuilt responses)
+    struct OutputSegment
+    {
+        string owned;
+        string_view borrowed;
+        bool is_owned;
+
+        string_view bytes() const { return is_owned ? string_view(owned) : borrowed; }
+    };
+
+    struct ScoringBatch;
+    struct EventLoop;
+
+    // Per-connection state; only one thread touches it at a time
+    struct Connection
+    {
+        SOCKET fd;
+        int epoll_fd = -1;
+        string input;
+        size_t input_consumed = 0; // bytes of input already answered
+        HttpRequestParser parser;
+        deque<OutputSegment> output;
+        size_t output_offset = 0;  // bytes of output.front() already sent
+        size_t output_pending = 0; // unsent bytes across all segments
+        string spare_output;       // a drained segment's buffer, kept for reuse
+        int requests_served = 0;
+        bool input_closed = false;
+        bool close_after_write = false;
+        bool corked = false;
+        atomic<int64_t> last_active_ms;
+        atomic<bool> idle; // between requests, nothing buffered either way
+        atomic<bool> busy; // a thread is answering its requests right now, or
+                           // it is parked until its batch has more results
+        shared_ptr<ScoringBatch> stream; // batch whose results are still going out
+        bool stream_chunked = false;
+#ifdef LASU_HAVE_IO_URING
+        // io_uring backend: operations the kernel still holds for this
+        // connection; all of them must complete before it is freed
+        int uring_inflight = 0;
+        bool recv_armed = false;
+        bool recv_cancelling = false;
+        bool send_inflight = false;
+        bool closing = false;
+        msghdr send_message;
+        iovec send_chunks[16];
+#endif
+
+        explicit Connection(SOCKET socket_fd) : fd(socket_fd), last_active_ms(0), idle(false), busy(false) {}
+    };
+
+    // A batch request being scored. Workers that pick up a share, and the
+    // connection's own thread when it may, claim chunks of candidates until
+    // none are left; each chunk renders into its own slot of `results`.
+    // The connection sends the chunks in input order as they finish, and
+    // when the next one is not ready it parks: nobody services it until
+    // the thread that finishes that chunk hands it back.
+    struct ScoringBatch : ResponseStream
+    {
+        static const size_t chunk_size = 64;
+
+        string body;                    // copy of the request body while streaming
+        vector<string_view> candidates; // views into the body
+        bool array = false;             // JSON array, else NDJSON
+        string opening;                 // sent before the first result
+        string closing;                 // and after the last
+        vector<string> results;         // one per chunk, in input order
+        unique_ptr<atomic<bool>[]> finished;
+        atomic<size_t> next_chunk{0};
+        bool owner_scores = true;       // the connection's thread claims chunks too
+
+        // Touched only by whoever is servicing the connection
+        size_t sent = 0;                // chunks already queued as output
+
+        // Parking, under wait_mutex. With no owner the connection's thread
+        // is blocked on wait_cv instead (the platforms without epoll).
+        mutex wait_mutex;
+        condition_variable wait_cv;
+        bool waiting = false;            // for chunk `sent`
+        Connection *owner = nullptr;
+        EventLoop *owner_loop = nullptr; // io_uring: the ring to hand it to
+    };
+
+    // Unit of work handed from the network threads to the worker pool:
+    // connection events, or a share of a scoring batch
+    struct PendingConnection
+    {
+        Connection *conn = nullptr;
+        uint32_t events = 0;
+        shared_ptr<ScoringBatch> batch;
+    };
+
+    // An event loop accepts on its own listeners and watches the connections
+    // it accepted; workers do the reading, writing and request handling
+    struct EventLoop
+    {
+        int epoll_fd = -1;
+        vector<SOCKET> listeners;
+        unsigned cpu = 0;
+
+        // io_uring: parked connections handed back by the workers that
+        // finished their next chunk; resume_fd wakes the ring to serve them
+        int resume_fd = -1;
+        uint64_t resume_count = 0;
+        mutex resume_mutex;
+        vector<Connection *> resumed;
+    };
+
+    vector<SOCKET> listeners; // every listening socket, in handoff order
+    int port;
+    ServerOptions options;
+
+    // Connection header lines for either outcome, rendered once
+    static constexpr string_view close_headers = "Connection: close\r\n";
+    string keep_alive_headers;
+    atomic<bool> running;    // accepting, and offering keep-alive
+    atomic<bool> io_active;  // network loops still turning (outlives running while draining)
+    int wake_fd = -1;        // eventfd poked by stop() to interrupt the accept loop
+
+    int handoff_listener = -1; // control socket successors connect to
+    int handoff_channel = -1;  // open to our predecessor until we are accepting
+    bool handed_off = false;   // our listening sockets now belong to a successor
+    atomic<unsigned> open_listeners{0};
+
+    // For /api/stats: what the networking costs per request
+    atomic<uint64_t> requests_completed{0};
+    atomic<uint64_t> network_syscalls{0};
+    unique_ptr<WorkerPool<PendingConnection>> worker_pool;
+    unique_ptr<AsyncLogger> logger;
+    unique_ptr<MeritList> merit_list;
+
+    // GET / in every encoding, indexed by ContentEncoding
+    StaticVariant home_page[3];
+    StaticVariant subjects_catalog;
+
+    // Every open connection, so idle keep-alive sockets can be reaped
+    mutex connections_mutex;
+    unordered_set<Connection *> live_connections;
+
+public:
+    LASUHttpServer(int server_port, const ServerOptions &server_options = ServerOptions())
+        : port(server_port), options(server_options), running(false), io_active(false)
+    {
+
+#ifdef _WIN32
+        WSADATA wsaData;
+        if (WSAStartup(MAKEWORD(2, 2), &wsaData) != 0)
+        {
+            throw runtime_error("WSAStartup failed");
+        }
+#endif
+
+#ifdef __linux__
+        wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (wake_fd == -1)
+        {
+            throw runtime_error("Failed to create eventfd");
+        }
+#endif
+
+        logger = make_unique<AsyncLogger>(options.log_path, options.access_log_sample);
+        merit_list = make_unique<MeritList>(options.merit_list_size, options.max_merit_candidates);
+
+        // Build and check the score table before the first request needs it
+        ScreeningTable::global();
+        if (!options.cohort_path.empty())
+        {
+            loadCohort(options.cohort_path);
+        }
+        if (find_if(options.quotas.begin(), options.quotas.end(), [](size_t quota) { return quota > 0; }) !=
+            options.quotas.end())
+        {
+            if (options.cohort_path.empty())
+            {
+                throw runtime_error("--quotas needs a --cohort to fill them from");
+            }
+            applyQuotas(options.quotas);
+        }
+        keep_alive_headers = "Connection: keep-alive\r\nKeep-Alive: timeout=" +
+                             to_string(options.idle_timeout_seconds) + "\r\n";
+        buildStaticResponses();
+    }
+
+    ~LASUHttpServer()
+    {
+        stop();
+        for (SOCKET listener : listeners)
+        {
+            closesocket(listener);
+        }
+#ifdef __linux__
+        close(wake_fd);
+#endif
+#ifdef _WIN32
+        WSACleanup();
+#endif
+    }
+
+    void start()
+    {
+#ifdef __linux__
+        takeOverListeners();
+        while (listeners.size() < eventLoopCount())
+        {
+            // Extra SO_REUSEPORT sockets join the group the kernel balances
+            // across; one that cannot be opened leaves its loop sharing
+            SOCKET listener = openListener(true);
+            if (listener == INVALID_SOCKET)
+            {
+                if (listeners.empty())
+                {
+                    throw runtime_error("Failed to listen on port " + to_string(port));
+                }
+                cerr << "Warning: could not add a listener, continuing with "
+                     << listeners.size() << endl;
+                break;
+            }
+            listeners.push_back(listener);
+        }
+#else
+        SOCKET listener = openListener(false);
+        if (listener == INVALID_SOCKET)
+        {
+            throw runtime_error("Failed to listen on port " + to_string(port));
+        }
+        listeners.push_back(listener);
+#endif
+
+#ifdef __linux__
+        if (options.backend == NetworkBackend::IoUring)
+        {
+            string reason = "not compiled in";
+#ifdef LASU_HAVE_IO_URING
+            if (!uringSupported(reason))
+#endif
+            {
+                cerr << "Warning: io_uring unavailable (" << reason << "), using epoll" << endl;
+                options.backend = NetworkBackend::Epoll;
+            }
+        }
+#endif
+
+        running = true;
+        io_active = true;
+        cout << "LASU Screening HTTP Server started on port " << port << endl;
+        cout << "Access the calculator at: http://localhost:" << port << endl;
+
+        worker_pool.reset(new WorkerPool<PendingConnection>(
+            workerCount(), 1024, [this](PendingConnection &pending)
+            { serviceConnection(pending); }));
+
+#ifdef __linux__
+        runEventLoops();
+#else
+        while (running)
+        {
+            sockaddr_in client_addr{};
+            socklen_t client_len = sizeof(client_addr);
+
+            SOCKET client_socket = accept(listeners[0],
+                                          reinterpret_cast<sockaddr *>(&client_addr),
+                                          &client_len);
+
+            if (client_socket != INVALID_SOCKET)
+            {
+                tuneSocket(client_socket);
+                worker_pool->submit({new Connection(client_socket), 0, nullptr});
+            }
+        }
+#endif
+
+        worker_pool->shutdown();
+        cout << "Server stopped" << endl;
+    }
+
+    // Begins a graceful shutdown; start() returns once connections have
+    // drained. Async-signal-safe, so it can be called from a signal handler.
+    void stop()
+    {
+        running = false;
+#ifdef __linux__
+        if (wake_fd != -1)
+        {
+            uint64_t one = 1;
+            ssize_t ignored = write(wake_fd, &one, sizeof(one));
+            (void)ignored;
+        }
+#endif
+    }
+
+private:
+    // Returns INVALID_SOCKET if the port cannot be bound
+    SOCKET openListener(bool reuse_port)
+    {
+        SOCKET listener = socket(AF_INET, SOCK_STREAM, 0);
+        if (listener == INVALID_SOCKET)
+        {
+            throw runtime_error("Failed to create socket");
+        }
+
+        // Set socket options
+        int opt = 1;
+        setsockopt(listener, SOL_SOCKET, SO_REUSEADDR,
+                   reinterpret_cast<const char *>(&opt), sizeof(opt));
+#ifdef SO_REUSEPORT
+        if (reuse_port)
+        {
+            setsockopt(listener, SOL_SOCKET, SO_REUSEPORT,
+                       reinterpret_cast<const char *>(&opt), sizeof(opt));
+        }
+#else
+        (void)reuse_port;
+#endif
+
+        sockaddr_in server_addr{};
+        server_addr.sin_family = AF_INET;
         server_addr.sin_addr.s_addr = INADDR_ANY;
         server_addr.sin_port = htons(port);
 
-        if (bind(server_socket, reinterpret_cast<sockaddr *>(&server_addr),
-                 sizeof(server_addr)) == SOCKET_ERROR)
-        {
-            throw runtime_error("Failed to bind socket");
-        }
+        if (bind(listener, reinterpret_cast<sockaddr *>(&server_addr),
+                 sizeof(server_addr)) == SOCKET_ERROR ||
+            listen(listener, options.listen_backlog) == SOCKET_ERROR)
+        {
+            closesocket(listener);
+            return INVALID_SOCKET;
+        }
+        return listener;
+    }
+
+    static unsigned workerCount()
+    {
+        return max(1u, thread::hardware_concurrency());
+    }
+
+    void serviceConnection(PendingConnection &pending)
+    {
+        if (pending.batch)
+        {
+            scoreBatchChunks(*pending.batch);
+            return;
+        }
+#ifdef __linux__
+        if (onConnectionEvent(pending.conn, pending.events))
+        {
+            rearm(pending.conn);
+        }
+#else
+        handleClient(pending.conn);
+        delete pending.conn;
+#endif
+    }
+
+    static int64_t nowMilliseconds()
+    {
+        return chrono::duration_cast<chrono::milliseconds>(
+                   chrono::steady_clock::now().time_since_epoch())
+            .count();
+    }
+
+    static bool outputDrained(const Connection *conn)
+    {
+        return conn->output_pending == 0;
+    }
+
+    // Replies are small and written whole, so Nagle would only hold the
+    // last segment of one back waiting for an ACK
+    static void tuneSocket(SOCKET fd)
+    {
+        int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char *>(&one), sizeof(one));
+    }
+
+    // The owned segment at the tail of the queue, for small output to be
+    // rendered straight into. Heads, pipelined JSON and interim 100s all
+    // share it; a new one starts from the connection's spare buffer.
+    static string &outputBuffer(Connection *conn)
+    {
+        if (conn->output.empty() || !conn->output.back().is_owned ||
+            conn->output.back().owned.size() >= 16 * 1024)
+        {
+            conn->output.push_back({move(conn->spare_output), string_view(), true});
+            conn->spare_output = string();
+        }
+        return conn->output.back().owned;
+    }
+
+    void queueOutput(Connection *conn, string data)
+    {
+        conn->output_pending += data.size();
+
+        // Anything big keeps its own buffer and is never copied
+        if (data.size() < 16 * 1024)
+        {
+            outputBuffer(conn) += data;
+            return;
+        }
+        conn->output.push_back({move(data), string_view(), true});
+    }
+
+    void queueStatic(Connection *conn, string_view data)
+    {
+        conn->output_pending += data.size();
+        conn->output.push_back({string(), data, false});
+    }
+
+    static void consumeOutput(Connection *conn, size_t sent)
+    {
+        conn->output_pending -= sent;
+        while (sent > 0)
+        {
+            size_t left_in_front = conn->output.front().bytes().size() - conn->output_offset;
+            if (sent < left_in_front)
+            {
+                conn->output_offset += sent;
+                return;
+            }
+            sent -= left_in_front;
+
+            // Keep one modest buffer around for the next response
+            OutputSegment &front = conn->output.front();
+            if (front.is_owned && front.owned.capacity() <= 64 * 1024 &&
+                front.owned.capacity() > conn->spare_output.capacity())
+            {
+                conn->spare_output = move(front.owned);
+                conn->spare_output.clear();
+            }
+            conn->output.pop_front();
+            conn->output_offset = 0;
+        }
+    }
+
+    void queueResponse(Connection *conn, HttpResponse &response, bool keep_alive)
+    {
+        if (response.prebuilt)
+        {
+            queueStatic(conn, keep_alive ? response.prebuilt->keep_alive_head
+                                         : response.prebuilt->close_head);
+            finishHead(conn, outputBuffer(conn));
+            queueStatic(conn, response.prebuilt->body);
+            return;
+        }
+
+        // The head is rendered into the connection's buffer; the body
+        // follows as its own iovec when it is too big to share one
+        string &buffer = outputBuffer(conn);
+        size_t before = buffer.size();
+        response.appendHead(buffer, keep_alive ? string_view(keep_alive_headers) : close_headers);
+        conn->output_pending += buffer.size() - before;
+        finishHead(conn, buffer);
+        queueOutput(conn, move(response.body));
+    }
+
+    static void finishHead(Connection *conn, string &buffer)
+    {
+        string_view date = httpDateLine();
+        buffer.append(date);
+        buffer.append("\r\n");
+        conn->output_pending += date.size() + 2;
+    }
+
+#ifndef _WIN32
+    // Points `chunks` at up to `limit` segments of unsent output, in order
+    static size_t gatherOutput(Connection *conn, iovec *chunks, size_t limit)
+    {
+        size_t count = 0;
+        for (auto it = conn->output.begin(); it != conn->output.end() && count < limit; ++it, ++count)
+        {
+            string_view bytes = it->bytes();
+            size_t skip = count == 0 ? conn->output_offset : 0;
+            chunks[count].iov_base = const_cast<char *>(bytes.data() + skip);
+            chunks[count].iov_len = bytes.size() - skip;
+        }
+        return count;
+    }
+#endif
+
+    // Answers every complete request in the input buffer, in arrival order.
+    // Returns true if it stopped early so queued output can be sent first
+    // (too much of it, or a streamed batch just produced more); call again
+    // once it has been. While a batch streams, later requests wait.
+    bool processRequests(Connection *conn)
+    {
+        bool paused = false;
+        while (true)
+        {
+            if (conn->stream)
+            {
+                paused = pumpStream(conn);
+                if (paused || conn->stream)
+                {
+                    break;
+                }
+            }
+            if (conn->close_after_write)
+            {
+                break;
+            }
+            if (conn->output_pending >= options.max_pending_output)
+            {
+                paused = true;
+                break;
+            }
+
+            HttpRequestParser &parser = conn->parser;
+            bool was_waiting_for_body = parser.headersComplete();
+            string_view pending = string_view(conn->input).substr(conn->input_consumed);
+            auto result = parser.advance(pending, options.max_header_bytes, options.max_body_bytes);
+
+            if (result == HttpRequestParser::Result::Incomplete)
+            {
+                if (!was_waiting_for_body && parser.expectsContinue())
+                {
+                    queueOutput(conn, "HTTP/1.1 100 Continue\r\n\r\n");
+                }
+                break;
+            }
+
+            if (result != HttpRequestParser::Result::Ready)
+            {
+                HttpResponse response = rejectionResponse(result);
+                conn->close_after_write = true;
+                queueResponse(conn, response, false);
+                break;
+            }
+
+            const HttpRequest &request = parser.request();
+            bool sampled = logger->sampleAccess();
+            auto began = sampled ? chrono::steady_clock::now() : chrono::steady_clock::time_point();
+            HttpResponse response = handleRequest(request);
+            requests_completed.fetch_add(1, memory_order_relaxed);
+            if (sampled)
+            {
+                logAccess(request, response, began);
+            }
+
+            ++conn->requests_served;
+            bool keep_alive = request.keepAlive() && running &&
+                              conn->requests_served < options.max_requests_per_connection;
+            if (response.stream)
+            {
+                // HTTP/1.0 has no chunked encoding: the close ends the body
+                response.chunked = request.version != "HTTP/1.0";
+                keep_alive = keep_alive && response.chunked;
+            }
+            if (!keep_alive)
+            {
+                conn->close_after_write = true;
+            }
+
+            queueResponse(conn, response, keep_alive);
+            if (response.stream)
+            {
+                conn->stream = static_pointer_cast<ScoringBatch>(move(response.stream));
+                conn->stream_chunked = response.chunked;
+                queueStreamPiece(conn, move(conn->stream->opening));
+            }
+            conn->input_consumed += parser.frameLength();
+            parser.reset();
+        }
+
+        // Compact once per batch rather than once per pipelined request
+        if (conn->input_consumed > 0)
+        {
+            conn->input.erase(0, conn->input_consumed);
+            conn->input_consumed = 0;
+        }
+        return paused;
+    }
+
+    // Queues the batch's finished chunks in input order, scoring unclaimed
+    // ones itself when it may. True if it stopped so the output can be sent
+    // first; conn->stream is cleared once the whole body is queued.
+    bool pumpStream(Connection *conn)
+    {
+        ScoringBatch &batch = *conn->stream;
+        size_t chunks = batch.results.size();
+        bool queued = false;
+        while (batch.sent < chunks)
+        {
+            if (conn->output_pending >= options.max_pending_output)
+            {
+                return true;
+            }
+            if (batch.finished[batch.sent].load(memory_order_acquire))
+            {
+                queueStreamPiece(conn, move(batch.results[batch.sent]));
+                ++batch.sent;
+                queued = true;
+                continue;
+            }
+            if (!batch.owner_scores || !scoreBatchChunk(batch))
+            {
+                break;
+            }
+            // Send what is ready before scoring more
+            if (queued)
+            {
+                return true;
+            }
+        }
+
+        if (batch.sent == chunks)
+        {
+            queueStreamPiece(conn, move(batch.closing));
+            if (conn->stream_chunked)
+            {
+                queueOutput(conn, "0\r\n\r\n");
+            }
+            conn->stream.reset();
+        }
+        return false;
+    }
+
+    void queueStreamPiece(Connection *conn, string piece)
+    {
+        if (piece.empty())
+        {
+            return; // an empty chunk would end the body
+        }
+        if (conn->stream_chunked)
+        {
+            char size[20];
+            char *end = to_chars(size, size + sizeof(size), piece.size(), 16).ptr;
+            queueOutput(conn, string(size, end) + "\r\n");
+            queueOutput(conn, move(piece));
+            queueOutput(conn, "\r\n");
+            return;
+        }
+        queueOutput(conn, move(piece));
+    }
+
+    // Called by the connection's thread, with nothing else left to send,
+    // as the last thing it does with the connection. True if the next
+    // chunk is still being scored: the connection is parked and the thread
+    // that finishes the chunk hands it back (to `loop` for io_uring, else
+    // to the worker pool). False if it is ready after all.
+    bool parkStream(Connection *conn, EventLoop *loop)
+    {
+        ScoringBatch &batch = *conn->stream;
+        lock_guard<mutex> lock(batch.wait_mutex);
+        if (batch.finished[batch.sent].load(memory_order_acquire))
+        {
+            return false;
+        }
+        batch.waiting = true;
+        batch.owner = conn;
+        batch.owner_loop = loop;
+        return true;
+    }
+
+    // Blocking counterpart of parkStream for handleClient
+    void awaitStream(Connection *conn)
+    {
+        ScoringBatch &batch = *conn->stream;
+        unique_lock<mutex> lock(batch.wait_mutex);
+        batch.waiting = true;
+        batch.owner = nullptr;
+        batch.wait_cv.wait(lock, [&batch]
+                           { return batch.finished[batch.sent].load(memory_order_acquire); });
+        batch.waiting = false;
+    }
+
+    // Stops the batch from handing the connection back, because it is
+    // going away or its thread has taken it up again
+    static void detachStream(Connection *conn)
+    {
+        if (conn->stream)
+        {
+            lock_guard<mutex> lock(conn->stream->wait_mutex);
+            conn->stream->waiting = false;
+            conn->stream->owner = nullptr;
+        }
+    }
+
+    void logAccess(const HttpRequest &request, const HttpResponse &response,
+                   chrono::steady_clock::time_point began)
+    {
+        const PrebuiltResponse *prebuilt = response.prebuilt;
+        auto elapsed = chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - began);
+        logger->access(request.method, request.path,
+                       prebuilt ? prebuilt->status_code : response.status_code,
+                       prebuilt ? prebuilt->body.size() : response.body.size(), elapsed.count());
+    }
+
+    static HttpResponse rejectionResponse(HttpRequestParser::Result result)
+    {
+        switch (result)
+        {
+        case HttpRequestParser::Result::HeadersTooLarge:
+        {
+            HttpResponse response(431, "Request Header Fields Too Large");
+            response.body = "<h1>431 - Request Header Fields Too Large</h1>";
+            return response;
+        }
+        case HttpRequestParser::Result::BodyTooLarge:
+        {
+            HttpResponse response(413, "Payload Too Large");
+            response.body = "<h1>413 - Payload Too Large</h1>";
+            return response;
+        }
+        default:
+        {
+            HttpResponse response(400, "Bad Request");
+            response.body = "<h1>400 - Bad Request</h1>";
+            return response;
+        }
+        }
+    }
+
+#ifdef __linux__
+    unsigned eventLoopCount() const
+    {
+        if (options.event_loops > 0)
+        {
+            return options.event_loops;
+        }
+        return static_cast<unsigned>(max<size_t>(1, allowedCpus().size()));
+    }
+
+    // CPUs this process may run on, so pinning respects taskset/cgroups
+    static vector<unsigned> allowedCpus()
+    {
+        vector<unsigned> cpus;
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        if (sched_getaffinity(0, sizeof(set), &set) == 0)
+        {
+            for (unsigned cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+            {
+                if (CPU_ISSET(cpu, &set))
+                {
+                    cpus.push_back(cpu);
+                }
+            }
+        }
+        return cpus;
+    }
+
+    static bool setNonBlocking(SOCKET fd)
+    {
+        int flags = fcntl(fd, F_GETFL, 0);
+        return flags != -1 && fcntl(fd, F_SETFL, flags | O_NONBLOCK) != -1;
+    }
+
+    // Hot restart protocol over the handoff socket:
+    //   successor connects -> predecessor sends its listening fds (SCM_RIGHTS)
+    //   successor starts accepting on them -> replies one byte
+    //   predecessor stops accepting, drains and exits
+    // Every listener of the SO_REUSEPORT group is passed, since closing one
+    // would reset the connections queued on it; the kernel listen queues
+    // stay open throughout, so no connection is refused.
+
+    static bool handoffAddress(const string &path, sockaddr_un &address)
+    {
+        address = sockaddr_un{};
+        address.sun_family = AF_UNIX;
+        if (path.size() >= sizeof(address.sun_path))
+        {
+            return false;
+        }
+        copy(path.begin(), path.end(), address.sun_path);
+        return true;
+    }
+
+    // One SCM_RIGHTS message carries at most 253 descriptors (SCM_MAX_FD)
+    // and there is a listener per allowed CPU, so the count goes first and
+    // the descriptors follow in batches of this many
+    static const size_t handoff_batch = 64;
+
+    static bool sendDescriptors(int channel, const vector<int> &fds)
+    {
+        uint32_t count = static_cast<uint32_t>(fds.size());
+        if (send(channel, &count, sizeof(count), MSG_NOSIGNAL) != static_cast<ssize_t>(sizeof(count)))
+        {
+            return false;
+        }
+
+        for (size_t sent = 0; sent < fds.size(); sent += handoff_batch)
+        {
+            size_t batch = min(handoff_batch, fds.size() - sent);
+            char tag = 'L';
+            iovec payload{&tag, 1};
+
+            alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int) * handoff_batch)];
+            msghdr message{};
+            message.msg_iov = &payload;
+            message.msg_iovlen = 1;
+            message.msg_control = control;
+            message.msg_controllen = CMSG_SPACE(sizeof(int) * batch);
+
+            cmsghdr *header = CMSG_FIRSTHDR(&message);
+            header->cmsg_level = SOL_SOCKET;
+            header->cmsg_type = SCM_RIGHTS;
+            header->cmsg_len = CMSG_LEN(sizeof(int) * batch);
+            memcpy(CMSG_DATA(header), fds.data() + sent, sizeof(int) * batch);
+
+            if (sendmsg(channel, &message, MSG_NOSIGNAL) != 1)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Fails, closing whatever arrived, unless every descriptor the
+    // predecessor announced is received intact
+    static bool receiveDescriptors(int channel, vector<int> &fds)
+    {
+        uint32_t count = 0;
+        if (recv(channel, &count, sizeof(count), MSG_WAITALL) != static_cast<ssize_t>(sizeof(count)) || count == 0)
+        {
+            return false;
+        }
+
+        auto fail = [&fds]()
+        {
+            for (int fd : fds)
+            {
+                close(fd);
+            }
+            fds.clear();
+            return false;
+        };
+
+        while (fds.size() < count)
+        {
+            char tag = 0;
+            iovec payload{&tag, 1};
+
+            alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int) * handoff_batch)];
+            msghdr message{};
+            message.msg_iov = &payload;
+            message.msg_iovlen = 1;
+            message.msg_control = control;
+            message.msg_controllen = sizeof(control);
+
+            ssize_t received = recvmsg(channel, &message, MSG_CMSG_CLOEXEC);
+            size_t before = fds.size();
+            if (received == 1)
+            {
+                for (cmsghdr *header = CMSG_FIRSTHDR(&message); header; header = CMSG_NXTHDR(&message, header))
+                {
+                    if (header->cmsg_level == SOL_SOCKET && header->cmsg_type == SCM_RIGHTS)
+                    {
+                        size_t batch = (header->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+                        fds.resize(before + batch);
+                        memcpy(fds.data() + before, CMSG_DATA(header), sizeof(int) * batch);
+                    }
+                }
+            }
+            // A truncated control message means descriptors were dropped
+            // in transit; their listeners would be lost with them
+            if (received != 1 || tag != 'L' || (message.msg_flags & MSG_CTRUNC) || fds.size() == before ||
+                fds.size() > count)
+            {
+                return fail();
+            }
+        }
+        return true;
+    }
+
+    // Adopts the listening sockets of a running predecessor, if there is
+    // one; otherwise this is a cold start and listeners stays empty
+    void takeOverListeners()
+    {
+        sockaddr_un address;
+        if (options.handoff_socket_path.empty() || !handoffAddress(options.handoff_socket_path, address))
+        {
+            return;
+        }
+
+        int channel = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (channel == -1)
+        {
+            return;
+        }
+        if (connect(channel, reinterpret_cast<sockaddr *>(&address), sizeof(address)) == -1)
+        {
+            close(channel); // nobody listening: stale path or first start
+            return;
+        }
+
+        vector<int> fds;
+        if (!receiveDescriptors(channel, fds))
+        {
+            close(channel);
+            throw runtime_error("Handoff from running server failed");
+        }
+
+        listeners.assign(fds.begin(), fds.end());
+        handoff_channel = channel;
+        cout << "Took over " << listeners.size() << " listening socket(s) from the running server" << endl;
+    }
+
+    // Tells the predecessor we are accepting, then claims the handoff path
+    // for our own successor
+    void openHandoffSocket()
+    {
+        if (handoff_channel != -1)
+        {
+            char ready = 'R';
+            ssize_t ignored = send(handoff_channel, &ready, 1, MSG_NOSIGNAL);
+            (void)ignored;
+            close(handoff_channel);
+            handoff_channel = -1;
+        }
+
+        sockaddr_un address;
+        if (options.handoff_socket_path.empty() || !handoffAddress(options.handoff_socket_path, address))
+        {
+            return;
+        }
+
+        unlink(options.handoff_socket_path.c_str());
+        handoff_listener = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (handoff_listener == -1 ||
+            bind(handoff_listener, reinterpret_cast<sockaddr *>(&address), sizeof(address)) == -1 ||
+            listen(handoff_listener, 1) == -1)
+        {
+            cerr << "Warning: hot restart disabled, cannot listen on "
+                 << options.handoff_socket_path << endl;
+            if (handoff_listener != -1)
+            {
+                close(handoff_listener);
+                handoff_listener = -1;
+            }
+        }
+    }
+
+    // A successor has connected: give it the listening sockets and, once it
+    // confirms it is accepting, start our own graceful shutdown
+    void handOffListener()
+    {
+        int channel = accept4(handoff_listener, nullptr, nullptr, SOCK_CLOEXEC);
+        if (channel == -1)
+        {
+            return;
+        }
+
+        pollfd reply{channel, POLLIN, 0};
+        char ready = 0;
+        if (sendDescriptors(channel, listeners) && poll(&reply, 1, 5000) == 1 &&
+            recv(channel, &ready, 1, 0) == 1 && ready == 'R')
+        {
+            cout << "Listening sockets handed to new process; draining" << endl;
+            handed_off = true;
+            stop();
+        }
+        else
+        {
+            cerr << "Warning: successor did not confirm handoff; still serving" << endl;
+        }
+        close(channel);
+    }
+
+    void runEventLoops()
+    {
+        // Spread the listeners over the loops; after a takeover there may be
+        // more of them than loops, and every one must keep being accepted on
+        vector<EventLoop> loops(min<size_t>(eventLoopCount(), listeners.size()));
+        vector<unsigned> cpus = allowedCpus();
+        for (size_t i = 0; i < loops.size(); ++i)
+        {
+            loops[i].epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+            if (loops[i].epoll_fd == -1)
+            {
+                throw runtime_error("Failed to create epoll instance");
+            }
+            loops[i].cpu = cpus.empty() ? 0 : cpus[i % cpus.size()];
+            if (options.backend == NetworkBackend::IoUring)
+            {
+                loops[i].resume_fd = eventfd(0, EFD_CLOEXEC);
+                if (loops[i].resume_fd == -1)
+                {
+                    throw runtime_error("Failed to create eventfd");
+                }
+            }
+        }
+        for (size_t i = 0; i < listeners.size(); ++i)
+        {
+            if (!setNonBlocking(listeners[i]))
+            {
+                throw runtime_error("Failed to make listening socket non-blocking");
+            }
+
+            EventLoop &loop = loops[i % loops.size()];
+            loop.listeners.push_back(listeners[i]);
+
+            // Listeners are told apart from connections by a null pointer
+            epoll_event listen_event{};
+            listen_event.events = EPOLLIN | EPOLLET;
+            listen_event.data.ptr = nullptr;
+            if (options.backend == NetworkBackend::Epoll)
+            {
+                epoll_ctl(loop.epoll_fd, EPOLL_CTL_ADD, listeners[i], &listen_event);
+            }
+        }
+        open_listeners = static_cast<unsigned>(loops.size());
+
+        vector<thread> io_threads;
+        for (EventLoop &loop : loops)
+        {
+#ifdef LASU_HAVE_IO_URING
+            if (options.backend == NetworkBackend::IoUring)
+            {
+                io_threads.emplace_back(&LASUHttpServer::runUringLoop, this, ref(loop));
+                continue;
+            }
+#endif
+            io_threads.emplace_back(&LASUHttpServer::runIoLoop, this, ref(loop));
+        }
+        cout << "Accepting on " << listeners.size() << " listener(s) across "
+             << loops.size() << " " << backendName() << " event loop(s)" << endl;
+
+        // This thread only handles control: stop(), handoff and idle sweeps
+        int control_epoll = epoll_create1(EPOLL_CLOEXEC);
+        if (control_epoll == -1)
+        {
+            throw runtime_error("Failed to create epoll instance");
+        }
+
+        epoll_event wake_event{};
+        wake_event.events = EPOLLIN;
+        wake_event.data.fd = wake_fd;
+        epoll_ctl(control_epoll, EPOLL_CTL_ADD, wake_fd, &wake_event);
+
+        openHandoffSocket();
+        if (handoff_listener != -1)
+        {
+            epoll_event handoff_event{};
+            handoff_event.events = EPOLLIN;
+            handoff_event.data.fd = handoff_listener;
+            epoll_ctl(control_epoll, EPOLL_CTL_ADD, handoff_listener, &handoff_event);
+        }
+
+        int64_t last_sweep = nowMilliseconds();
+        epoll_event events[4];
+        while (running)
+        {
+            int ready = epoll_wait(control_epoll, events, 4, 1000);
+            if (ready == -1 && errno != EINTR)
+            {
+                break;
+            }
+
+            for (int i = 0; i < ready; ++i)
+            {
+                if (events[i].data.fd == handoff_listener)
+                {
+                    handOffListener();
+                }
+            }
+
+            if (nowMilliseconds() - last_sweep >= 1000)
+            {
+                closeIdleConnections();
+                last_sweep = nowMilliseconds();
+            }
+        }
+
+        // Each loop closes its own listeners once it sees running drop
+        while (open_listeners > 0)
+        {
+            this_thread::sleep_for(chrono::milliseconds(10));
+        }
+        listeners.clear();
+
+        if (handoff_listener != -1)
+        {
+            close(handoff_listener);
+            handoff_listener = -1;
+            // The path now belongs to the successor if there is one
+            if (!handed_off)
+            {
+                unlink(options.handoff_socket_path.c_str());
+            }
+        }
+
+        drainConnections();
+
+        io_active = false;
+        for (auto &io_thread : io_threads)
+        {
+            io_thread.join();
+        }
+        worker_pool->shutdown();
+
+        // Anything still registered was cut at the deadline and never woke up
+        for (Connection *conn : live_connections)
+        {
+            closesocket(conn->fd);
+            delete conn;
+        }
+        live_connections.clear();
+
+        for (EventLoop &loop : loops)
+        {
+            close(loop.epoll_fd);
+            if (loop.resume_fd != -1)
+            {
+                close(loop.resume_fd);
+            }
+        }
+        close(control_epoll);
+    }
+
+    // Waits for in-flight requests to be answered. Their responses already
+    // say Connection: close because running is false; idle keep-alive
+    // connections are closed straight away. At the deadline the rest are cut.
+    void drainConnections()
+    {
+        int64_t deadline = nowMilliseconds() + options.drain_timeout_seconds * 1000LL;
+        size_t initial;
+        {
+            lock_guard<mutex> lock(connections_mutex);
+            initial = live_connections.size();
+        }
+        cout << "Shutting down: draining " << initial << " connection(s)" << endl;
+
+        while (true)
+        {
+            {
+                lock_guard<mutex> lock(connections_mutex);
+                if (live_connections.empty())
+                {
+                    return;
+                }
+
+                bool expired = nowMilliseconds() >= deadline;
+                for (Connection *conn : live_connections)
+                {
+                    if (expired || conn->idle.load(memory_order_acquire))
+                    {
+                        shutdown(conn->fd, SHUT_RDWR);
+                    }
+                }
+
+                if (expired)
+                {
+                    cout << "Drain deadline reached, cutting " << live_connections.size()
+                         << " connection(s)" << endl;
+                    break;
+                }
+            }
+            this_thread::sleep_for(chrono::milliseconds(50));
+        }
+
+        // Give the owners of the cut sockets a moment to notice and close them
+        for (int i = 0; i < 20; ++i)
+        {
+            this_thread::sleep_for(chrono::milliseconds(50));
+            lock_guard<mutex> lock(connections_mutex);
+            if (live_connections.empty())
+            {
+                return;
+            }
+        }
+    }
+
+    void acceptPending(EventLoop &loop, SOCKET listener)
+    {
+        // Edge-triggered: drain the whole accept queue before waiting again
+        while (true)
+        {
+            SOCKET client_socket = accept4(listener, nullptr, nullptr,
+                                           SOCK_NONBLOCK | SOCK_CLOEXEC);
+            countSyscalls(1);
+            if (client_socket == INVALID_SOCKET)
+            {
+                if (errno == EINTR || errno == ECONNABORTED)
+                {
+                    continue;
+                }
+                return; // EAGAIN, or out of descriptors until some close
+            }
+
+            tuneSocket(client_socket);
+            countSyscalls(1);
+
+            Connection *conn = new Connection(client_socket);
+            conn->epoll_fd = loop.epoll_fd;
+            conn->last_active_ms = nowMilliseconds();
+            {
+                lock_guard<mutex> lock(connections_mutex);
+                live_connections.insert(conn);
+            }
+
+            // One-shot: the connection is disarmed while a worker owns it
+            epoll_event event{};
+            event.events = EPOLLIN | EPOLLRDHUP | EPOLLET | EPOLLONESHOT;
+            event.data.ptr = conn;
+
+            countSyscalls(1);
+            if (epoll_ctl(conn->epoll_fd, EPOLL_CTL_ADD, client_socket, &event) == -1)
+            {
+                closeConnection(conn);
+            }
+        }
+    }
+
+    static void pinToCpu(unsigned cpu)
+    {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpu, &set);
+        pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+    }
+
+    void countSyscalls(uint64_t count)
+    {
+        network_syscalls.fetch_add(count, memory_order_relaxed);
+    }
+
+    void runIoLoop(EventLoop &loop)
+    {
+        pinToCpu(loop.cpu);
+
+        bool accepting = true;
+        epoll_event events[64];
+        while (io_active)
+        {
+            int ready = epoll_wait(loop.epoll_fd, events, 64, 100);
+            countSyscalls(1);
+            for (int i = 0; i < ready; ++i)
+            {
+                if (events[i].data.ptr == nullptr)
+                {
+                    // Edge-triggered, and we cannot tell which listener fired
+                    for (SOCKET listener : loop.listeners)
+                    {
+                        acceptPending(loop, listener);
+                    }
+                    continue;
+                }
+
+                // Blocks while the pool is saturated, which is the backpressure
+                worker_pool->submit({static_cast<Connection *>(events[i].data.ptr),
+                                     events[i].events, nullptr});
+            }
+
+            if (accepting && !running)
+            {
+                stopAccepting(loop);
+                accepting = false;
+            }
+        }
+    }
+
+    // Takes whatever already finished the handshake, then stops listening so
+    // new clients are refused instead of left hanging in the backlog. After
+    // a handoff the queues belong to the successor, which keeps the sockets
+    // open; only our descriptors go away.
+    void stopAccepting(EventLoop &loop)
+    {
+        for (SOCKET listener : loop.listeners)
+        {
+            if (!handed_off)
+            {
+                acceptPending(loop, listener);
+            }
+            epoll_ctl(loop.epoll_fd, EPOLL_CTL_DEL, listener, nullptr);
+            closesocket(listener);
+        }
+        loop.listeners.clear();
+        --open_listeners;
+    }
+
+    // Shutting the socket down wakes its owner with EOF, so the connection is
+    // still closed by whichever worker picks it up and never under its feet
+    void closeIdleConnections()
+    {
+        int64_t idle_limit = options.idle_timeout_seconds * 1000LL;
+        int64_t now = nowMilliseconds();
+
+        // A connection being answered is left alone however long its
+        // requests take; the timeout is for peers that have gone quiet
+        lock_guard<mutex> lock(connections_mutex);
+        for (Connection *conn : live_connections)
+        {
+            if (!conn->busy.load(memory_order_acquire) &&
+                now - conn->last_active_ms.load(memory_order_acquire) > idle_limit)
+            {
+                shutdown(conn->fd, SHUT_RDWR);
+            }
+        }
+    }
+
+    void rearm(Connection *conn)
+    {
+        epoll_event event{};
+        event.events = EPOLLET | EPOLLONESHOT;
+        if (!conn->input_closed && !conn->close_after_write)
+        {
+            event.events |= EPOLLIN | EPOLLRDHUP;
+        }
+        if (!outputDrained(conn))
+        {
+            event.events |= EPOLLOUT;
+        }
+        event.data.ptr = conn;
+
+        countSyscalls(1);
+        if (epoll_ctl(conn->epoll_fd, EPOLL_CTL_MOD, conn->fd, &event) == -1)
+        {
+            closeConnection(conn);
+        }
+    }
+
+    // Returns false once the connection has been closed, or parked until
+    // its batch has more results
+    bool onConnectionEvent(Connection *conn, uint32_t events)
+    {
+        if (events & EPOLLERR)
+        {
+            closeConnection(conn);
+            return false;
+        }
+
+        conn->busy.store(true, memory_order_release);
+        conn->last_active_ms.store(nowMilliseconds(), memory_order_release);
+        conn->idle.store(false, memory_order_release);
+
+        if ((events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP)) && !conn->input_closed)
+        {
+            conn->input_closed = !readAvailable(conn);
+        }
+
+        bool paused;
+        while (true)
+        {
+            do
+            {
+                paused = processRequests(conn);
+                if (!flushOutput(conn))
+                {
+                    closeConnection(conn);
+                    return false;
+                }
+            } while (paused && outputDrained(conn));
+
+            // A batch still streaming with everything sent so far: wait for
+            // its next chunk without holding this thread. Unsent output
+            // instead waits for EPOLLOUT, which pumps the batch again.
+            if (!conn->stream || paused || !outputDrained(conn))
+            {
+                break;
+            }
+            if (parkStream(conn, nullptr))
+            {
+                return false;
+            }
+        }
+
+        // Nothing more can arrive; a trailing partial request is dropped
+        if (conn->input_closed && !paused)
+        {
+            conn->close_after_write = true;
+        }
+
+        if (conn->close_after_write && outputDrained(conn))
+        {
+            closeConnection(conn);
+            return false;
+        }
+
+        conn->idle.store(conn->input.empty() && outputDrained(conn), memory_order_release);
+        conn->last_active_ms.store(nowMilliseconds(), memory_order_release);
+        conn->busy.store(false, memory_order_release);
+        return true;
+    }
+
+    // Reads until the socket would block or the buffer holds more than any
+    // acceptable request. Returns false once the peer has closed its side or
+    // the connection failed.
+    bool readAvailable(Connection *conn)
+    {
+        // Past one maximal request plus slack the parser will reject anyway;
+        // leave the rest in the kernel, the one-shot rearm will report it
+        size_t read_limit = options.max_header_bytes + options.max_body_bytes + 65536;
+
+        char buffer[16384];
+        while (conn->input.size() < read_limit)
+        {
+            ssize_t n = recv(conn->fd, buffer, sizeof(buffer), 0);
+            countSyscalls(1);
+            if (n > 0)
+            {
+                conn->input.append(buffer, static_cast<size_t>(n));
+                continue;
+            }
+            if (n == 0)
+            {
+                return false;
+            }
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            return errno == EAGAIN || errno == EWOULDBLOCK;
+        }
+        return true;
+    }
+
+    // Large output is corked until it has all been written; taking the cork
+    // off pushes out the final partial segment
+    void setCork(Connection *conn, bool cork)
+    {
+        int value = cork ? 1 : 0;
+        setsockopt(conn->fd, IPPROTO_TCP, TCP_CORK, &value, sizeof(value));
+        countSyscalls(1);
+        conn->corked = cork;
+    }
+
+    // Writes as much pending output as the socket accepts, gathering up to
+    // 64 segments per call. Returns false on a hard error; EAGAIN leaves the
+    // rest for the next EPOLLOUT edge.
+    bool flushOutput(Connection *conn)
+    {
+        if (!conn->corked && conn->output_pending >= options.cork_threshold)
+        {
+            setCork(conn, true);
+        }
+
+        while (!outputDrained(conn))
+        {
+            iovec chunks[64];
+            msghdr message{};
+            message.msg_iov = chunks;
+            message.msg_iovlen = gatherOutput(conn, chunks, 64);
+
+            // sendmsg rather than writev for MSG_NOSIGNAL
+            ssize_t n = sendmsg(conn->fd, &message, MSG_NOSIGNAL);
+            countSyscalls(1);
+            if (n > 0)
+            {
+                consumeOutput(conn, static_cast<size_t>(n));
+                continue;
+            }
+            if (n == -1 && errno == EINTR)
+            {
+                continue;
+            }
+            return n == -1 && (errno == EAGAIN || errno == EWOULDBLOCK);
+        }
+
+        if (conn->corked)
+        {
+            setCork(conn, false);
+        }
+        return true;
+    }
+
+    void closeConnection(Connection *conn)
+    {
+        detachStream(conn);
+        {
+            lock_guard<mutex> lock(connections_mutex);
+            live_connections.erase(conn);
+        }
+
+        // close() also removes the descriptor from the epoll set
+        closesocket(conn->fd);
+        countSyscalls(1);
+        delete conn;
+    }
+#endif
+
+#ifdef LASU_HAVE_IO_URING
+    // io_uring backend. Each event loop owns a ring and does its own I/O
+    // and request handling, so nothing crosses threads on the hot path.
+    // Accepts and receives are multishot, receives draw from a provided
+    // buffer ring, and every SQE queued while handling one batch of
+    // completions reaches the kernel in the io_uring_enter that waits for
+    // the next batch.
+    enum UringOp : uint64_t
+    {
+        UringAccept = 1, // upper bits: listener index
+        UringRecv = 2,   // upper bits: Connection*
+        UringSend = 3,
+        UringCancel = 4,
+        UringResume = 5, // the loop's resume_fd was written
+    };
+    static const uint64_t uring_op_mask = 7;
+
+    struct UringLoop
+    {
+        IoUring ring;
+        IoUringBufferRing buffers;
+        EventLoop &loop;
+        unordered_set<Connection *> connections;
+        bool accepting = true;
+
+        explicit UringLoop(EventLoop &event_loop)
+            : ring(1024), buffers(ring, 0, 1024, 4096), loop(event_loop) {}
+    };
+
+    // DEFER_TASKRUN (kernel 6.1) postdates multishot receive, so a ring
+    // with a buffer ring is enough to know the backend will work
+    static bool uringSupported(string &reason)
+    {
+        try
+        {
+            IoUring ring(8);
+            IoUringBufferRing buffers(ring, 0, 8, 4096);
+            return true;
+        }
+        catch (const exception &e)
+        {
+            reason = e.what();
+            return false;
+        }
+    }
+
+    static uint64_t uringData(Connection *conn, UringOp op)
+    {
+        return reinterpret_cast<uint64_t>(conn) | op;
+    }
+
+    void runUringLoop(EventLoop &loop)
+    {
+        pinToCpu(loop.cpu);
+
+        unique_ptr<UringLoop> state;
+        try
+        {
+            state.reset(new UringLoop(loop));
+        }
+        catch (const exception &e)
+        {
+            cerr << "Error: io_uring event loop failed to start: " << e.what() << endl;
+            for (SOCKET listener : loop.listeners)
+            {
+                closesocket(listener);
+            }
+            loop.listeners.clear();
+            --open_listeners;
+            stop();
+            return;
+        }
+
+        UringLoop &uring = *state;
+        for (size_t i = 0; i < loop.listeners.size(); ++i)
+        {
+            armUringAccept(uring, i);
+        }
+        armUringResume(uring);
+
+        int64_t exit_deadline = 0;
+        uint64_t enters_counted = 0;
+        while (io_active || !uring.connections.empty())
+        {
+            // After the drain whatever is left is cut; give the kernel a
+            // moment to hand back the operations it holds for them
+            if (!io_active)
+            {
+                if (exit_deadline == 0)
+                {
+                    exit_deadline = nowMilliseconds() + 1000;
+                    for (Connection *conn : vector<Connection *>(uring.connections.begin(), uring.connections.end()))
+                    {
+                        beginUringClose(uring, conn);
+                    }
+                }
+                if (nowMilliseconds() >= exit_deadline)
+                {
+                    break;
+                }
+            }
+
+            uring.ring.submitAndWait(1, 100);
+            uring.ring.forEachCompletion([this, &uring](const io_uring_cqe &cqe)
+                                         { onUringCompletion(uring, cqe); });
+
+            countSyscalls(uring.ring.enterCalls() - enters_counted);
+            enters_counted = uring.ring.enterCalls();
+
+            if (uring.accepting && !running)
+            {
+                stopUringAccepting(uring);
+            }
+        }
+    }
+
+    void onUringCompletion(UringLoop &uring, const io_uring_cqe &cqe)
+    {
+        bool more = (cqe.flags & IORING_CQE_F_MORE) != 0;
+        Connection *conn = reinterpret_cast<Connection *>(cqe.user_data & ~uring_op_mask);
+
+        switch (cqe.user_data & uring_op_mask)
+        {
+        case UringAccept:
+            if (cqe.res >= 0)
+            {
+                adoptUringConnection(uring, cqe.res);
+            }
+            if (!more && uring.accepting)
+            {
+                armUringAccept(uring, static_cast<size_t>(cqe.user_data >> 3));
+            }
+            break;
+
+        case UringRecv:
+            if (!more)
+            {
+                conn->recv_armed = false;
+                conn->recv_cancelling = false;
+                --conn->uring_inflight;
+            }
+            if (cqe.res > 0 && (cqe.flags & IORING_CQE_F_BUFFER))
+            {
+                uint16_t id = static_cast<uint16_t>(cqe.flags >> IORING_CQE_BUFFER_SHIFT);
+                conn->input.append(uring.buffers.data(id), static_cast<size_t>(cqe.res));
+                uring.buffers.recycle(id);
+            }
+            else if (cqe.res == 0 || (cqe.res != -ENOBUFS && cqe.res != -ECANCELED))
+            {
+                conn->input_closed = true;
+            }
+            serviceUringConnection(uring, conn);
+            break;
+
+        case UringSend:
+            conn->send_inflight = false;
+            --conn->uring_inflight;
+            if (cqe.res > 0 && !conn->closing)
+            {
+                consumeOutput(conn, static_cast<size_t>(cqe.res));
+            }
+            else if (cqe.res < 0 && cqe.res != -EAGAIN && cqe.res != -EINTR)
+            {
+                beginUringClose(uring, conn);
+                break;
+            }
+            serviceUringConnection(uring, conn);
+            break;
+
+        case UringResume:
+        {
+            vector<Connection *> resumed;
+            {
+                lock_guard<mutex> lock(uring.loop.resume_mutex);
+                resumed.swap(uring.loop.resumed);
+            }
+            for (Connection *resumed_conn : resumed)
+            {
+                serviceUringConnection(uring, resumed_conn);
+            }
+            armUringResume(uring);
+            break;
+        }
+
+        default: // cancellations report nothing we need
+            break;
+        }
+    }
+
+    void adoptUringConnection(UringLoop &uring, SOCKET client_socket)
+    {
+        tuneSocket(client_socket);
+        countSyscalls(1);
+
+        Connection *conn = new Connection(client_socket);
+        conn->last_active_ms = nowMilliseconds();
+        {
+            lock_guard<mutex> lock(connections_mutex);
+            live_connections.insert(conn);
+        }
+        uring.connections.insert(conn);
+        armUringReceive(uring, conn);
+    }
+
+    void armUringAccept(UringLoop &uring, size_t index)
+    {
+        io_uring_sqe *sqe = uring.ring.getSqe();
+        sqe->opcode = IORING_OP_ACCEPT;
+        sqe->fd = uring.loop.listeners[index];
+        sqe->ioprio = IORING_ACCEPT_MULTISHOT;
+        sqe->accept_flags = SOCK_CLOEXEC;
+        sqe->user_data = (static_cast<uint64_t>(index) << 3) | UringAccept;
+    }
+
+    void armUringReceive(UringLoop &uring, Connection *conn)
+    {
+        io_uring_sqe *sqe = uring.ring.getSqe();
+        sqe->opcode = IORING_OP_RECV;
+        sqe->fd = conn->fd;
+        sqe->ioprio = IORING_RECV_MULTISHOT;
+        sqe->flags = IOSQE_BUFFER_SELECT;
+        sqe->buf_group = uring.buffers.groupId();
+        sqe->user_data = uringData(conn, UringRecv);
+        conn->recv_armed = true;
+        ++conn->uring_inflight;
+    }
+
+    void armUringResume(UringLoop &uring)
+    {
+        io_uring_sqe *sqe = uring.ring.getSqe();
+        sqe->opcode = IORING_OP_READ;
+        sqe->fd = uring.loop.resume_fd;
+        sqe->addr = reinterpret_cast<uint64_t>(&uring.loop.resume_count);
+        sqe->len = sizeof(uring.loop.resume_count);
+        sqe->user_data = UringResume;
+    }
+
+    void cancelUring(UringLoop &uring, uint64_t target)
+    {
+        io_uring_sqe *sqe = uring.ring.getSqe();
+        sqe->opcode = IORING_OP_ASYNC_CANCEL;
+        sqe->addr = target;
+        sqe->user_data = UringCancel;
+    }
+
+    // One send in flight per connection, gathering up to 16 segments. The
+    // output queue is left alone until it completes, since the kernel may
+    // read the segments right up to then.
+    void startUringSend(UringLoop &uring, Connection *conn)
+    {
+        if (!conn->corked && conn->output_pending >= options.cork_threshold)
+        {
+            setCork(conn, true);
+        }
+
+        conn->send_message = msghdr{};
+        conn->send_message.msg_iov = conn->send_chunks;
+        conn->send_message.msg_iovlen = gatherOutput(conn, conn->send_chunks, 16);
+
+        io_uring_sqe *sqe = uring.ring.getSqe();
+        sqe->opcode = IORING_OP_SENDMSG;
+        sqe->fd = conn->fd;
+        sqe->addr = reinterpret_cast<uint64_t>(&conn->send_message);
+        sqe->len = 1;
+        sqe->msg_flags = MSG_NOSIGNAL;
+        sqe->user_data = uringData(conn, UringSend);
+        conn->send_inflight = true;
+        ++conn->uring_inflight;
+    }
+
+    // Counterpart of onConnectionEvent: answer what has arrived, queue the
+    // send, and keep a receive armed only while there is room for input
+    void serviceUringConnection(UringLoop &uring, Connection *conn)
+    {
+        if (conn->closing)
+        {
+            finishUringClose(uring, conn);
+            return;
+        }
+
+        conn->busy.store(true, memory_order_release);
+        conn->last_active_ms.store(nowMilliseconds(), memory_order_release);
+        conn->idle.store(false, memory_order_release);
+
+        // Woken by its socket while parked: take it back from the batch,
+        // which must not hand it over while this thread moves it along
+        detachStream(conn);
+
+        bool parked = false;
+        while (!conn->send_inflight)
+        {
+            bool paused = processRequests(conn);
+
+            // Nothing more can arrive; a trailing partial request is dropped
+            if (conn->input_closed && !paused)
+            {
+                conn->close_after_write = true;
+            }
+            if (!outputDrained(conn))
+            {
+                startUringSend(uring, conn);
+                break;
+            }
+            // A batch still streaming: its next chunk comes back through
+            // resume_fd, unless it finished in the meantime
+            if (conn->stream)
+            {
+                parked = parkStream(conn, &uring.loop);
+                if (parked)
+                {
+                    break;
+                }
+                continue;
+            }
+            if (conn->corked)
+            {
+                setCork(conn, false);
+            }
+            if (conn->close_after_write)
+            {
+                beginUringClose(uring, conn);
+                return;
+            }
+            break;
+        }
+
+        size_t read_limit = options.max_header_bytes + options.max_body_bytes + 65536;
+        bool want_input = !conn->input_closed && !conn->close_after_write &&
+                          conn->output_pending < options.max_pending_output &&
+                          conn->input.size() < read_limit;
+        if (want_input && !conn->recv_armed)
+        {
+            armUringReceive(uring, conn);
+        }
+        else if (!want_input && conn->recv_armed && !conn->recv_cancelling)
+        {
+            cancelUring(uring, uringData(conn, UringRecv));
+            conn->recv_cancelling = true;
+        }
+
+        conn->idle.store(!conn->stream && conn->input.empty() && outputDrained(conn), memory_order_release);
+        conn->last_active_ms.store(nowMilliseconds(), memory_order_release);
+        conn->busy.store(parked, memory_order_release);
+    }
+
+    // Shutting the socket down completes the pending receive; the
+    // connection is freed once the kernel has returned every operation
+    void beginUringClose(UringLoop &uring, Connection *conn)
+    {
+        if (!conn->closing)
+        {
+            conn->closing = true;
+            shutdown(conn->fd, SHUT_RDWR);
+            countSyscalls(1);
+        }
+        finishUringClose(uring, conn);
+    }
+
+    void finishUringClose(UringLoop &uring, Connection *conn)
+    {
+        if (conn->uring_inflight > 0)
+        {
+            return;
+        }
+        detachStream(conn);
+        {
+            lock_guard<mutex> lock(uring.loop.resume_mutex);
+            auto &resumed = uring.loop.resumed;
+            resumed.erase(remove(resumed.begin(), resumed.end(), conn), resumed.end());
+        }
+        {
+            lock_guard<mutex> lock(connections_mutex);
+            live_connections.erase(conn);
+        }
+        uring.connections.erase(conn);
+        closesocket(conn->fd);
+        countSyscalls(1);
+        delete conn;
+    }
+
+    // Same contract as stopAccepting() for the epoll loops
+    void stopUringAccepting(UringLoop &uring)
+    {
+        uring.accepting = false;
+        for (size_t i = 0; i < uring.loop.listeners.size(); ++i)
+        {
+            cancelUring(uring, (static_cast<uint64_t>(i) << 3) | UringAccept);
+        }
+        uring.ring.submitAndWait(0, 0);
+
+        for (SOCKET listener : uring.loop.listeners)
+        {
+            while (!handed_off)
+            {
+                SOCKET client_socket = accept4(listener, nullptr, nullptr, SOCK_CLOEXEC);
+                countSyscalls(1);
+                if (client_socket == INVALID_SOCKET)
+                {
+                    if (errno == EINTR || errno == ECONNABORTED)
+                        continue;
+                    break;
+                }
+                adoptUringConnection(uring, client_socket);
+            }
+            closesocket(listener);
+        }
+        uring.loop.listeners.clear();
+        --open_listeners;
+    }
+#endif
+
+    // Blocking fallback for platforms without epoll; the receive timeout
+    // doubles as the keep-alive idle timeout
+    void handleClient(Connection *conn)
+    {
+#ifdef _WIN32
+        DWORD timeout = options.idle_timeout_seconds * 1000;
+#else
+        timeval timeout{options.idle_timeout_seconds, 0};
+#endif
+        setsockopt(conn->fd, SOL_SOCKET, SO_RCVTIMEO,
+                   reinterpret_cast<const char *>(&timeout), sizeof(timeout));
+
+        char buffer[4096];
+        while (!conn->close_after_write)
+        {
+            int bytes_received = recv(conn->fd, buffer, sizeof(buffer), 0);
+            if (bytes_received <= 0)
+            {
+                break;
+            }
+            conn->input.append(buffer, bytes_received);
+
+            bool paused;
+            do
+            {
+                paused = processRequests(conn);
+                while (!outputDrained(conn))
+                {
+#ifdef _WIN32
+                    string_view bytes = conn->output.front().bytes().substr(conn->output_offset);
+                    int sent = send(conn->fd, bytes.data(), static_cast<int>(bytes.size()), 0);
+#else
+                    iovec chunks[64];
+                    ssize_t sent = writev(conn->fd, chunks, static_cast<int>(gatherOutput(conn, chunks, 64)));
+#endif
+                    if (sent <= 0)
+                    {
+                        closesocket(conn->fd);
+                        return;
+                    }
+                    consumeOutput(conn, static_cast<size_t>(sent));
+                }
+                if (!paused && conn->stream)
+                {
+                    awaitStream(conn);
+                    paused = true;
+                }
+            } while (paused);
+        }
+
+        closesocket(conn->fd);
+    }
+
+    void prebuild(PrebuiltResponse &target, HttpResponse &response)
+    {
+        target.status_code = response.status_code;
+        response.appendHead(target.close_head, close_headers);
+        response.appendHead(target.keep_alive_head, keep_alive_headers);
+        target.body = move(response.body);
+    }
+
+    void prebuildVariant(StaticVariant &target, string body, const char *content_type,
+                         const char *encoding, int max_age_seconds, bool vary)
+    {
+        target.etag = strongETag(body);
 
-        if (listen(server_socket, 10) == SOCKET_ERROR)
+        HttpResponse ok;
+        ok.content_type = content_type;
+        ok.addHeader("ETag", target.etag);
+        ok.addHeader("Cache-Control", "public, max-age=" + to_string(max_age_seconds));
+        if (vary)
         {
-            throw runtime_error("Failed to listen on socket");
+            ok.addHeader("Vary", "Accept-Encoding");
         }
 
-        running = true;
-        cout << "LASU Screening HTTP Server started on port " << port << endl;
-        cout << "Access the calculator at: http://localhost:" << port << endl;
+        HttpResponse not_modified = ok;
+        not_modified.status_code = 304;
+        not_modified.status_text = "Not Modified";
+        not_modified.content_type = "";
 
-        while (running)
+        if (encoding)
         {
-            sockaddr_in client_addr{};
-            socklen_t client_len = sizeof(client_addr);
-
-            SOCKET client_socket = accept(server_socket,
-                                          reinterpret_cast<sockaddr *>(&client_addr),
-                                          &client_len);
-
-            if (client_socket != INVALID_SOCKET)
-            {
-                thread(&LASUHttpServer::handleClient, this, client_socket).detach();
-            }
+            ok.addHeader("Content-Encoding", encoding);
         }
-    }
+        ok.body = move(body);
 
-    void stop()
-    {
-        running = false;
+        prebuild(target.ok, ok);
+        prebuild(target.not_modified, not_modified);
     }
 
-private:
-    void handleClient(SOCKET client_socket)
+    void buildStaticResponses()
     {
-        char buffer[4096];
-        int bytes_received = recv(client_socket, buffer, sizeof(buffer) - 1, 0);
+        string page = generateHomePage();
+        int page_age = options.page_max_age_seconds;
 
-        if (bytes_received > 0)
-        {
-            buffer[bytes_received] = '\0';
-            string raw_request(buffer);
+        prebuildVariant(home_page[static_cast<int>(ContentEncoding::Identity)], page, "text/html",
+                        nullptr, page_age, true);
+#ifdef LASU_HAVE_ZLIB
+        prebuildVariant(home_page[static_cast<int>(ContentEncoding::Gzip)], gzipCompress(page),
+                        "text/html", "gzip", page_age, true);
+#endif
+#ifdef LASU_HAVE_BROTLI
+        prebuildVariant(home_page[static_cast<int>(ContentEncoding::Brotli)], brotliCompress(page),
+                        "text/html", "br", page_age, true);
+#endif
 
-            HttpRequest request = HttpRequest::parse(raw_request);
-            HttpResponse response = handleRequest(request);
+        prebuildVariant(subjects_catalog, generateSubjectsJSON(), "application/json", nullptr,
+                        options.catalog_max_age_seconds, false);
+    }
 
-            string response_str = response.toString();
-            send(client_socket, response_str.c_str(), response_str.length(), 0);
+    static const PrebuiltResponse *selectResponse(const StaticVariant &variant, const HttpRequest &request)
+    {
+        string_view if_none_match = request.header("If-None-Match");
+        if (!if_none_match.empty() && etagMatches(if_none_match, variant.etag))
+        {
+            return &variant.not_modified;
         }
-
-        closesocket(client_socket);
+        return &variant.ok;
     }
 
     HttpResponse handleRequest(const HttpRequest &request)
@@ -663,12 +3377,26 @@ private:
         {
             if (request.path == "/" || request.path == "/index.html")
             {
-                response.body = generateHomePage();
+                ContentEncoding encoding = negotiateEncoding(request.header("Accept-Encoding"));
+                response.prebuilt = selectResponse(home_page[static_cast<int>(encoding)], request);
             }
             else if (request.path == "/api/subjects")
             {
-                response.headers["Content-Type"] = "application/json";
-                response.body = generateSubjectsJSON();
+                response.prebuilt = selectResponse(subjects_catalog, request);
+            }
+            else if (request.path == "/api/stats")
+            {
+                response.content_type = "application/json";
+                response.body = generateStatsJSON();
+            }
+            else if (request.path.substr(0, request.path.find('?')) == "/api/merit")
+            {
+                response = handleMeritList(request.path);
+            }
+            else if (request.path == "/api/cutoffs")
+            {
+                response.content_type = "application/json";
+                response.body = generateCutoffsJSON();
             }
             else
             {
@@ -680,9 +3408,13 @@ private:
         {
             if (request.path == "/api/calculate")
             {
-                response.headers["Content-Type"] = "application/json";
+                response.content_type = "application/json";
                 response.body = handleCalculation(request.body);
             }
+            else if (request.path == "/api/calculate/batch")
+            {
+                response = handleBatchCalculation(request.body);
+            }
             else
             {
                 response = HttpResponse(404, "Not Found");
@@ -1344,192 +4076,811 @@ string generateHomePage()
         })";
     }
 
-    string handleCalculation(const string &json_body)
+    const char *backendName() const
     {
-        try
+#ifdef __linux__
+        return options.backend == NetworkBackend::IoUring ? "io_uring" : "epoll";
+#else
+        return "blocking";
+#endif
+    }
+
+    string generateStatsJSON()
+    {
+        if (!worker_pool)
         {
-            // JSON parsing
-            regex course_regex("\"courseCategory\"\\s*:\\s*(\\d+)");
-            regex jamb_regex("\"jambScore\"\\s*:\\s*(\\d+)");
-            regex required_regex("\"([^\"]+)\"\\s*:\\s*\"([^\"]+)\"");
-            regex optional_name_regex("\"name\"\\s*:\\s*\"([^\"]+)\"");
-            regex optional_grade_regex("\"grade\"\\s*:\\s*\"([^\"]+)\"");
+            return "{}";
+        }
 
-            smatch match;
+        auto stats = worker_pool->stats();
+        ostringstream json;
+        json << fixed << setprecision(3);
+        json << "{"
+             << "\"workers\": " << stats.workers << ","
+             << "\"busyWorkers\": " << stats.busy_workers << ","
+             << "\"queueDepth\": " << stats.queue_depth << ","
+             << "\"queueCapacity\": " << stats.queue_capacity << ","
+             << "\"jobsCompleted\": " << stats.jobs_completed << ","
+             << "\"backpressureWaits\": " << stats.backpressure_waits << ","
+             << "\"workerWakeups\": " << stats.wakeups << ","
+             << "\"workerUtilisation\": " << stats.utilisation << ","
+             << "\"backend\": \"" << backendName() << "\","
+             << "\"requestsServed\": " << requests_completed.load(memory_order_relaxed) << ","
+             << "\"networkSyscalls\": " << network_syscalls.load(memory_order_relaxed)
+             << "}";
+        return json.str();
+    }
 
-            // Parse course category
-            int courseCategory = 0;
-            if (regex_search(json_body, match, course_regex))
-            {
-                courseCategory = stoi(match[1].str());
-            }
+    // Constant parts of the /api/calculate response, between its slots
+    static constexpr string_view calculation_json[] = {
+        "{\"jambScore\": ", ",\"jambPercentage\": ", ",\"waecScore\": ", ",\"waecPercentage\": ",
+        ",\"finalScore\": ", ",\"admissionStatus\": \"", "\",\"status\": \"", "\"}"};
 
-            // Parse JAMB score
-            int jambScore = 0;
-            if (regex_search(json_body, match, jamb_regex))
+    // {"error": "<prefix><detail>"}, with the detail escaped
+    static void appendError(string &json, string_view prefix, string_view detail)
+    {
+        json.append("{\"error\": \"");
+        json.append(prefix);
+        appendJsonEscaped(json, detail);
+        json.append("\"}");
+    }
+
+    string handleCalculation(string_view json_body)
+    {
+        // Rendered into a buffer each thread reuses, then copied out at its
+        // exact size
+        thread_local string json;
+        json.clear();
+        json.reserve(256);
+        appendCalculation(json_body, json);
+        return json;
+    }
+
+    // Scores one candidate and appends its /api/calculate JSON to `json`
+    void appendCalculation(string_view json_body, string &json)
+    {
+        size_t start = json.size();
+        try
+        {
+            // The parsed request lives in the arena; only the response body
+            // outlives it
+            RequestArena arena;
+            ScreeningRequest input(arena.resource());
+            string parse_error;
+            if (!parseScreeningRequest(json_body, input, parse_error))
             {
-                jambScore = stoi(match[1].str());
+                appendError(json, "Invalid JSON: ", parse_error);
+                return;
             }
 
-            if (courseCategory == 0 || jambScore == 0)
+            // Missing and negative values never got past the original digits-only
+            // match, so they are refused here rather than scored as zero
+            if (input.course_category <= 0 || input.jamb_score <= 0)
             {
-                return "{\"error\": \"Invalid course category or JAMB score\"}";
+                appendError(json, "Invalid course category or JAMB score", "");
+                return;
             }
 
             // Create calculator instance
             LASUScreeningAggregator calculator;
-            calculator.setJambScore(jambScore);
-            calculator.setRequiredSubjects(courseCategory);
+            char digits[16];
+            auto digitsOf = [&digits](int value)
+            {
+                return string_view(digits, static_cast<size_t>(to_chars(digits, digits + sizeof(digits), value).ptr - digits));
+            };
+
+            // Rejected input is scored as before (as zero) and noted in the log
+            if (!calculator.setJambScore(input.jamb_score))
+            {
+                logger->event("warn", "invalid_jamb_score", {{"jambScore", digitsOf(input.jamb_score)}});
+            }
+            if (!calculator.setRequiredSubjects(input.course_category))
+            {
+                logger->event("warn", "invalid_course_category", {{"courseCategory", digitsOf(input.course_category)}});
+            }
 
-            // Parse required subjects
-            string requiredSubjectsSection = extractSection(json_body, "requiredSubjects");
-            if (!requiredSubjectsSection.empty())
+            for (const auto &subject : input.required_subjects)
             {
-                auto subjects = parseRequiredSubjects(requiredSubjectsSection);
-                for (const auto &subject : subjects)
+                if (!calculator.addGrade(subject.first, subject.second))
                 {
-                    calculator.addGrade(subject.first, subject.second);
+                    logger->event("warn", "invalid_grade", {{"subject", subject.first}, {"grade", subject.second}});
                 }
             }
 
-            // Parse optional subjects
-            string optionalSubjectsSection = extractSection(json_body, "optionalSubjects");
-            if (!optionalSubjectsSection.empty())
+            for (const auto &subject : input.optional_subjects)
             {
-                auto optionalSubjects = parseOptionalSubjects(optionalSubjectsSection);
-                for (const auto &subject : optionalSubjects)
+                if (!calculator.addOptionalSubject(subject.first, subject.second))
                 {
-                    calculator.addOptionalSubject(subject.first, subject.second);
+                    logger->event("warn", "invalid_grade", {{"subject", subject.first}, {"grade", subject.second}});
                 }
             }
 
             // Calculate results
             calculator.calculateScreeningResults();
+            const FacultyPolicy &policy = calculator.getFacultyPolicy();
+            for (size_t i = 0; i < policy.required_count; ++i)
+            {
+                if (calculator.isRequiredSubjectMissing(i))
+                {
+                    logger->event("warn", "missing_required_subject", {{"subject", subjectName(policy.required[i])}});
+                }
+            }
 
-            // Generate JSON response
-            ostringstream response;
-            response << fixed << setprecision(1);
-            response << "{"
-                     << "\"jambScore\": " << calculator.getJambScore() << ","
-                     << "\"jambPercentage\": " << calculator.getJambPercentage() << ","
-                     << "\"waecScore\": " << calculator.getTotalScore() << ","
-                     << "\"waecPercentage\": " << calculator.getPercentage() << ","
-                     << "\"finalScore\": " << calculator.getFinalScreeningScore() << ","
-                     << "\"admissionStatus\": \"" << calculator.getAdmissionStatus() << "\","
-                     << "\"status\": \"" << getStatusClass(calculator.getFinalScreeningScore()) << "\""
-                     << "}";
-
-            return response.str();
+            // Fill the template's slots
+            json.append(calculation_json[0]);
+            appendInteger(json, calculator.getJambScore());
+            json.append(calculation_json[1]);
+            appendFixed1(json, calculator.getJambPercentage());
+            json.append(calculation_json[2]);
+            appendInteger(json, calculator.getTotalScore());
+            json.append(calculation_json[3]);
+            appendFixed1(json, calculator.getPercentage());
+            json.append(calculation_json[4]);
+            appendFixed1(json, calculator.getFinalScreeningScore());
+            json.append(calculation_json[5]);
+            json.append(calculator.getAdmissionStatus());
+            json.append(calculation_json[6]);
+            json.append(calculator.getStatusClass());
+            json.append(calculation_json[7]);
         }
         catch (const exception &e)
         {
-            return "{\"error\": \"" + string(e.what()) + "\"}";
+            json.resize(start);
+            appendError(json, "", e.what());
         }
     }
 
-private:
-    string extractSection(const string &json, const string &section)
+    // POST /api/calculate/batch: a JSON array of candidates, or NDJSON with
+    // one per line. Results come back in input order in the same shape,
+    // each exactly what /api/calculate returns for that candidate, so a
+    // bad candidate shows up as an inline {"error": ...}. A batch of one
+    // chunk is answered on the spot; larger ones are scored on the worker
+    // pool and streamed back chunk by chunk as they finish.
+    HttpResponse handleBatchCalculation(string_view body)
     {
-        string pattern = "\"" + section + "\"\\s*:\\s*\\{([^}]*)\\}";
-        regex section_regex(pattern);
-        smatch match;
+        auto batch = make_shared<ScoringBatch>();
+        string fault;
+        batch->array = splitCandidates(body, batch->candidates, fault);
+
+        HttpResponse response;
+        response.content_type = batch->array ? "application/json" : "application/x-ndjson";
+        if (batch->candidates.size() > options.max_batch_candidates)
+        {
+            response = HttpResponse(413, "Payload Too Large");
+            response.content_type = "application/json";
+            appendError(response.body, "Too many candidates, the limit is ",
+                        to_string(options.max_batch_candidates));
+            return response;
+        }
+
+        // Results carry their own separators, so what goes around them is
+        // known up front. An array that stops parsing part-way still
+        // answers for the candidates before the fault.
+        bool empty = batch->candidates.empty() && fault.empty();
+        batch->opening = batch->array ? (empty ? "[]" : "[\n") : "";
+        if (!fault.empty())
+        {
+            if (batch->array && !batch->candidates.empty())
+            {
+                batch->closing = ",\n";
+            }
+            appendError(batch->closing, "Invalid JSON: ", fault);
+            batch->closing += batch->array ? "" : "\n";
+        }
+        if (batch->array && !empty)
+        {
+            batch->closing += "\n]";
+        }
+
+        size_t chunks = (batch->candidates.size() + ScoringBatch::chunk_size - 1) / ScoringBatch::chunk_size;
+        batch->results.resize(chunks);
+        batch->finished.reset(new atomic<bool>[chunks]);
+        for (size_t i = 0; i < chunks; ++i)
+        {
+            batch->finished[i].store(false, memory_order_relaxed);
+        }
+
+        if (chunks <= 1)
+        {
+            scoreBatchChunk(*batch);
+            string &out = response.body;
+            out = move(batch->opening);
+            out += chunks == 1 ? batch->results[0] : string();
+            out += batch->closing;
+            return response;
+        }
 
-        if (regex_search(json, match, section_regex))
+        // The views must outlive the request buffer they point into
+        batch->body.assign(body.data(), body.size());
+        for (string_view &candidate : batch->candidates)
         {
-            return match[1].str();
+            candidate = string_view(batch->body.data() + (candidate.data() - body.data()), candidate.size());
         }
+        scoreBatch(batch);
+        response.stream = batch;
+        return response;
+    }
 
-        // Try array format for optional subjects
-        if (section == "optionalSubjects")
+    // Views of the candidates in a JSON array or NDJSON body; true for an
+    // array. If the array is malformed, the candidates before the fault
+    // are returned and the reason is left in `fault`.
+    static bool splitCandidates(string_view body, vector<string_view> &candidates, string &fault)
+    {
+        size_t first = body.find_first_not_of(" \t\r\n");
+        if (first != string_view::npos && body[first] == '[')
         {
-            pattern = "\"" + section + "\"\\s*:\\s*\\[([^\\]]*)\\]";
-            regex array_regex(pattern);
-            if (regex_search(json, match, array_regex))
+            JsonReader reader(body);
+            reader.beginArray();
+            while (reader.nextElement())
+            {
+                reader.peek();
+                size_t start = reader.offset();
+                if (!reader.skipValue())
+                {
+                    break;
+                }
+                candidates.push_back(body.substr(start, reader.offset() - start));
+            }
+            if (!reader.atEnd())
             {
-                return match[1].str();
+                fault = reader.ok() ? "Unexpected data after JSON value" : reader.error();
             }
+            return true;
         }
 
-        return "";
+        for (size_t start = 0; start < body.size();)
+        {
+            size_t end = min(body.find('\n', start), body.size());
+            string_view line = body.substr(start, end - start);
+            if (line.find_first_not_of(" \t\r") != string_view::npos)
+            {
+                candidates.push_back(line);
+            }
+            start = end + 1;
+        }
+        return false;
     }
 
-    vector<pair<string, string>> parseRequiredSubjects(const string &section)
+    // Offers shares of the batch to idle workers. Shares go through
+    // trySubmit, so a saturated pool just means the connection's own
+    // thread scores the chunks; on the io_uring loops it does so only if
+    // no share was taken, so a batch never holds up the ring otherwise.
+    void scoreBatch(const shared_ptr<ScoringBatch> &batch)
     {
-        vector<pair<string, string>> subjects;
-        regex subject_regex("\"([^\"]+)\"\\s*:\\s*\"([^\"]+)\"");
-        sregex_iterator iter(section.begin(), section.end(), subject_regex);
-        sregex_iterator end;
+        size_t chunks = batch->results.size();
+        size_t accepted = 0;
+        for (size_t i = 0; i < min<size_t>(chunks, workerCount()); ++i)
+        {
+            PendingConnection share;
+            share.batch = batch;
+            if (!worker_pool || !worker_pool->trySubmit(share))
+            {
+                break;
+            }
+            ++accepted;
+        }
+        batch->owner_scores = options.backend != NetworkBackend::IoUring || accepted == 0;
+    }
 
-        for (; iter != end; ++iter)
+    void scoreBatchChunks(ScoringBatch &batch)
+    {
+        while (scoreBatchChunk(batch))
         {
-            smatch match = *iter;
-            string subject = match[1].str();
-            string grade = match[2].str();
+        }
+    }
 
-            // Replace underscores with spaces (from form field names)
-            replace(subject.begin(), subject.end(), '_', ' ');
+    // Claims and scores the next unclaimed chunk; false if none is left
+    bool scoreBatchChunk(ScoringBatch &batch)
+    {
+        size_t chunks = batch.results.size();
+        size_t chunk = batch.next_chunk.fetch_add(1);
+        if (chunk >= chunks)
+        {
+            return false;
+        }
 
-            subjects.push_back({subject, grade});
+        size_t begin = chunk * ScoringBatch::chunk_size;
+        size_t end = min(begin + ScoringBatch::chunk_size, batch.candidates.size());
+        string &out = batch.results[chunk];
+        out.reserve((end - begin) * 200);
+        for (size_t i = begin; i < end; ++i)
+        {
+            if (batch.array && i > 0)
+            {
+                out += ",\n";
+            }
+            appendCalculation(batch.candidates[i], out);
+            if (!batch.array)
+            {
+                out += '\n';
+            }
         }
+        batch.finished[chunk].store(true, memory_order_release);
 
-        return subjects;
+        // Hand the connection back if it parked waiting for this chunk
+        PendingConnection resume;
+        {
+            lock_guard<mutex> lock(batch.wait_mutex);
+            if (!batch.waiting || batch.sent != chunk)
+            {
+                return true;
+            }
+            batch.waiting = false;
+            if (!batch.owner)
+            {
+                batch.wait_cv.notify_all();
+                return true;
+            }
+#ifdef LASU_HAVE_IO_URING
+            if (batch.owner_loop)
+            {
+                EventLoop &loop = *batch.owner_loop;
+                {
+                    lock_guard<mutex> resume_lock(loop.resume_mutex);
+                    loop.resumed.push_back(batch.owner);
+                }
+                uint64_t one = 1;
+                ssize_t ignored = write(loop.resume_fd, &one, sizeof(one));
+                (void)ignored;
+                return true;
+            }
+#endif
+            resume.conn = batch.owner;
+            if (worker_pool && worker_pool->trySubmit(resume))
+            {
+                return true;
+            }
+        }
+        // Pool full: this thread services the connection itself. Nobody
+        // else can reach a parked epoll connection, so no lock is needed.
+        serviceConnection(resume);
+        return true;
     }
 
-    vector<pair<string, string>> parseOptionalSubjects(const string &section)
+    // --cohort: scores every row of the CSV on all cores and puts each
+    // candidate on their faculty's merit list, in file order, so a
+    // candidate listed twice is ranked by their later row. Throws
+    // runtime_error if the file cannot be read, or holds more candidates
+    // than the lists may.
+    void loadCohort(const string &path)
     {
-        vector<pair<string, string>> subjects;
+        auto started = chrono::steady_clock::now();
+        ifstream file(path, ios::binary | ios::ate);
+        if (!file)
+        {
+            throw runtime_error("Cannot open cohort " + path);
+        }
+        string contents(static_cast<size_t>(file.tellg()), '\0');
+        file.seekg(0);
+        if (!file.read(&contents[0], static_cast<streamsize>(contents.size())))
+        {
+            throw runtime_error("Cannot read cohort " + path);
+        }
+
+        string_view rows = contents;
+        CsvLayout layout = readCohortHeader(rows);
+        if (layout.id == CsvLayout::none)
+        {
+            throw runtime_error("The cohort needs an id column");
+        }
 
-        // Parse array of objects: [{"name":"Subject","grade":"A1"}...]
-        regex object_regex("\\{[^}]*\\}");
-        sregex_iterator iter(section.begin(), section.end(), object_regex);
-        sregex_iterator end;
+        // Parsed and scored chunk by chunk on every core, then listed in
+        // file order on this thread
+        struct ScoredChunk
+        {
+            vector<string> ids;
+            CandidateStore store;
+            size_t rejected = 0;
+            size_t invalid_grades = 0;
+        };
+        vector<string_view> pieces = splitAtLineBreaks(rows, 1 << 20);
+        vector<ScoredChunk> chunks(pieces.size());
+        atomic<size_t> next_chunk{0};
+        auto scoreChunks = [&]()
+        {
+            CohortRowReader reader(layout);
+            string id;
+            CandidateGrades grades;
+            for (size_t index = next_chunk.fetch_add(1); index < chunks.size(); index = next_chunk.fetch_add(1))
+            {
+                ScoredChunk &chunk = chunks[index];
+                forEachCsvRow(pieces[index], [&](string_view line)
+                              {
+                                  int course_category, jamb_score;
+                                  if (reader.read(line, id, course_category, jamb_score, grades, chunk.invalid_grades) ||
+                                      id.empty() || facultyId(facultyPolicy(course_category)) == 0)
+                                  {
+                                      ++chunk.rejected;
+                                      return;
+                                  }
+                                  chunk.ids.push_back(id);
+                                  chunk.store.add(jamb_score, course_category, grades); });
+                chunk.store.score();
+            }
+        };
+        vector<thread> helpers;
+        for (size_t t = 1; t < min<size_t>(workerCount(), chunks.size()); ++t)
+        {
+            helpers.emplace_back(scoreChunks);
+        }
+        scoreChunks();
+        for (thread &helper : helpers)
+        {
+            helper.join();
+        }
 
-        for (; iter != end; ++iter)
+        size_t listed = 0, rejected = 0, invalid_grades = 0;
+        for (ScoredChunk &chunk : chunks)
         {
-            string object = iter->str();
+            const CandidateStore &store = chunk.store;
+            for (size_t i = 0; i < store.size(); ++i)
+            {
+                if (!merit_list->add(chunk.ids[i], store.faculty[i], store.final_score[i], store.jamb_score[i],
+                                     store.waec_total[i]))
+                {
+                    logger->event("error", "merit_list_full", {{"capacity", to_string(merit_list->capacity())}});
+                    throw runtime_error("The cohort has more than " + to_string(merit_list->capacity()) +
+                                        " candidates; raise --max-merit-candidates");
+                }
+                ++listed;
+            }
+            rejected += chunk.rejected;
+            invalid_grades += chunk.invalid_grades;
+            chunk = ScoredChunk();
+        }
 
-            regex name_regex("\"name\"\\s*:\\s*\"([^\"]+)\"");
-            regex grade_regex("\"grade\"\\s*:\\s*\"([^\"]+)\"");
+        merit_list->rank(workerCount());
 
-            smatch name_match, grade_match;
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - started).count();
+        cout << "Cohort: " << merit_list->size() << " candidates from " << listed << " rows (" << rejected
+             << " rejected, " << invalid_grades << " invalid grades skipped) in " << seconds << "s" << endl;
+        logger->event("info", "cohort_loaded",
+                      {{"path", path}, {"candidates", to_string(merit_list->size())}, {"rejected", to_string(rejected)}});
+    }
 
-            if (regex_search(object, name_match, name_regex) &&
-                regex_search(object, grade_match, grade_regex))
+    // Value of `name` in the request target's query string, empty when
+    // absent. Not percent-decoded: the parameters used are plain numbers.
+    static string_view queryParameter(string_view target, string_view name)
+    {
+        size_t separator = target.find('?');
+        while (separator != string_view::npos)
+        {
+            size_t start = separator + 1;
+            size_t end = min(target.find('&', start), target.size());
+            string_view pair = target.substr(start, end - start);
+            if (pair.size() > name.size() && pair.substr(0, name.size()) == name && pair[name.size()] == '=')
             {
-                subjects.push_back({name_match[1].str(), grade_match[1].str()});
+                return pair.substr(name.size() + 1);
             }
+            separator = end < target.size() ? end : string_view::npos;
+        }
+        return {};
+    }
+
+    // Reads query parameter `name` into `value` as a whole number, leaving
+    // `value` alone when absent; false when present but not a number
+    static bool parsePageParameter(string_view target, string_view name, size_t &value)
+    {
+        string_view text = queryParameter(target, name);
+        if (text.empty())
+        {
+            return true;
+        }
+        auto parsed = from_chars(text.data(), text.data() + text.size(), value);
+        return parsed.ec == errc() && parsed.ptr == text.data() + text.size();
+    }
+
+    // GET /api/merit?faculty=N: the course category's top candidates from
+    // the --cohort, best first. With &full=1 a page of the whole faculty's
+    // ranking instead: &offset=N places below the best, at most &limit=N
+    // candidates (capped at max_merit_page).
+    HttpResponse handleMeritList(string_view target)
+    {
+        HttpResponse response;
+        response.content_type = "application/json";
+
+        int faculty = 0;
+        string_view faculty_text = queryParameter(target, "faculty");
+        auto parsed = from_chars(faculty_text.data(), faculty_text.data() + faculty_text.size(), faculty);
+        if (parsed.ec != errc() || parsed.ptr != faculty_text.data() + faculty_text.size() || faculty < 1 ||
+            faculty > faculty_count)
+        {
+            response = HttpResponse(400, "Bad Request");
+            response.content_type = "application/json";
+            appendError(response.body, "faculty must be a course category from 1 to ", to_string(faculty_count));
+            return response;
+        }
+
+        bool full = queryParameter(target, "full") == "1";
+        size_t offset = 0;
+        size_t limit = options.max_merit_page;
+        if (full && !(parsePageParameter(target, "offset", offset) && parsePageParameter(target, "limit", limit)))
+        {
+            response = HttpResponse(400, "Bad Request");
+            response.content_type = "application/json";
+            appendError(response.body, "offset and limit must be whole numbers", "");
+            return response;
+        }
+        limit = min(limit, options.max_merit_page);
+
+        size_t candidates = merit_list->candidates(faculty);
+        vector<MeritEntry> ranked = full ? merit_list->page(faculty, offset, limit) : merit_list->top(faculty);
+
+        string &json = response.body;
+        json.reserve(128 + ranked.size() * 112);
+        json.append("{\"courseCategory\": ");
+        appendInteger(json, faculty);
+        json.append(",\"faculty\": \"");
+        appendJsonEscaped(json, faculty_policies[faculty].name);
+        json.append("\",\"candidates\": ");
+        appendInteger(json, static_cast<int64_t>(candidates));
+        if (full)
+        {
+            json.append(",\"offset\": ");
+            appendInteger(json, static_cast<int64_t>(offset));
+        }
+        json.append(",\"ranked\": [");
+        for (size_t i = 0; i < ranked.size(); ++i)
+        {
+            const MeritEntry &entry = ranked[i];
+            json.append(i ? ",\n{\"rank\": " : "\n{\"rank\": ");
+            appendInteger(json, static_cast<int64_t>(offset + i + 1));
+            json.append(",\"candidateId\": \"");
+            appendJsonEscaped(json, entry.candidate_id);
+            json.append("\",\"finalScore\": ");
+            appendFixed1(json, entry.final_score);
+            json.append(",\"jambScore\": ");
+            appendInteger(json, entry.jamb_score);
+            json.append(",\"waecScore\": ");
+            appendInteger(json, entry.waec_total);
+            json.append("}");
         }
+        json.append(ranked.empty() ? "]}" : "\n]}");
+        return response;
+    }
 
-        return subjects;
+    // GET /api/cutoffs: the cutoff each course category is judged against
+    // now, next to the published one
+    string generateCutoffsJSON() const
+    {
+        const ScreeningTable &table = ScreeningTable::global();
+        string json = "{\"cutoffs\": [";
+        for (int faculty = 1; faculty <= faculty_count; ++faculty)
+        {
+            json.append(faculty > 1 ? ",\n{\"courseCategory\": " : "\n{\"courseCategory\": ");
+            appendInteger(json, faculty);
+            json.append(",\"faculty\": \"");
+            appendJsonEscaped(json, faculty_policies[faculty].name);
+            json.append("\",\"cutoff\": ");
+            appendShortest(json, table.cutoff(faculty));
+            json.append(",\"publishedCutoff\": ");
+            appendShortest(json, faculty_policies[faculty].cutoff);
+            json.append(",\"candidates\": ");
+            appendInteger(json, static_cast<int64_t>(merit_list->candidates(faculty)));
+            json.append("}");
+        }
+        json.append("\n]}");
+        return json;
     }
 
-    string getStatusClass(double score)
+    // --quotas: sets each listed course category's cutoff to the score
+    // that fills its quota from the cohort, before the first request is
+    // scored. Quotas change with a restart (with --handoff-socket, without
+    // dropping requests), never over the network.
+    void applyQuotas(const vector<size_t> &quotas)
     {
-        if (score >= 70.0)
-            return "excellent";
-        if (score >= 60.0)
-            return "good";
-        if (score >= 50.0)
-            return "fair";
-        return "poor";
+        ScreeningTable &table = ScreeningTable::global();
+        for (const QuotaCutoff &result : solveQuotaCutoffs(*merit_list, quotas, workerCount()))
+        {
+            if (result.quota == 0)
+            {
+                continue;
+            }
+            if (result.candidates > 0 && result.cutoff != table.cutoff(result.faculty))
+            {
+                table.setCutoff(result.faculty, result.cutoff);
+            }
+
+            string cutoff_text;
+            appendShortest(cutoff_text, result.cutoff);
+            cout << "Quota: " << faculty_policies[result.faculty].name << " " << result.quota << " places, "
+                 << result.candidates << " candidates, cutoff " << cutoff_text;
+            if (result.candidates > 0)
+            {
+                cout << " (" << result.admitted << " admitted, last " << result.last_admitted << ")";
+            }
+            cout << endl;
+            logger->event("info", "cutoff_set",
+                          {{"courseCategory", to_string(result.faculty)},
+                           {"quota", to_string(result.quota)},
+                           {"candidates", to_string(result.candidates)},
+                           {"cutoff", cutoff_text}});
+        }
     }
 };
 
-int main()
+static LASUHttpServer *signal_target = nullptr;
+
+static void handleShutdownSignal(int)
+{
+    if (signal_target)
+    {
+        signal_target->stop();
+    }
+}
+
+static void installSignalHandlers()
+{
+#ifdef _WIN32
+    signal(SIGINT, handleShutdownSignal);
+    signal(SIGTERM, handleShutdownSignal);
+#else
+    // No SA_RESTART, so a blocking accept() returns EINTR and sees the stop
+    struct sigaction action{};
+    action.sa_handler = handleShutdownSignal;
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGINT, &action, nullptr);
+    sigaction(SIGTERM, &action, nullptr);
+
+    // A peer that hangs up mid-response is an error return, not a signal
+    signal(SIGPIPE, SIG_IGN);
+#endif
+}
+
+static void printUsage(const char *program)
+{
+    cout << "Usage: " << program << " [--port N] [--backlog N] [--event-loops N]\n"
+         << "       [--max-header-bytes N] [--max-body-bytes N]\n"
+         << "       [--backend epoll|io_uring] [--handoff-socket PATH]\n"
+         << "       [--log-file PATH] [--access-log-sample N] [--cohort PATH]\n"
+         << "       [--merit-list-size N] [--max-merit-candidates N]\n"
+         << "       [--quotas CATEGORY=PLACES,...]\n"
+         << "  --port N               TCP port to listen on (default 8080)\n"
+         << "  --backlog N            listen queue length per listener (default 1024)\n"
+         << "  --max-header-bytes N   larger request headers get 431 (default 16384)\n"
+         << "  --max-body-bytes N     larger request bodies get 413 (default 8388608)\n"
+         << "  --event-loops N        accepting event loops, one per core if 0 (default)\n"
+         << "  --backend NAME         epoll (default) or io_uring, Linux only\n"
+         << "  --handoff-socket PATH  enable zero-downtime upgrades: start the new\n"
+         << "                         binary with the same PATH and it takes over\n"
+         << "                         the listening sockets while this one drains\n"
+         << "  --log-file PATH        JSON-lines log for diagnostics and access\n"
+         << "                         records (default stderr)\n"
+         << "  --access-log-sample N  log every Nth request, 0 for none (default)\n"
+         << "  --cohort PATH          candidate CSV (lasu_bulk_score format, with an\n"
+         << "                         id column) ranked for GET /api/merit\n"
+         << "  --merit-list-size N    candidates per faculty in GET /api/merit\n"
+         << "                         (default 100)\n"
+         << "  --max-merit-candidates N\n"
+         << "                         largest cohort accepted (default 5000000)\n"
+         << "  --quotas LIST          admission places per course category, e.g.\n"
+         << "                         5=120,6=80; each listed category's cutoff is\n"
+         << "                         set to the score that fills it from --cohort\n";
+}
+
+// Reads "5=120,6=80" into places per course category; false if malformed
+static bool parseQuotas(string_view text, vector<size_t> &quotas)
+{
+    quotas.assign(faculty_count + 1, 0);
+    for (size_t start = 0; start <= text.size();)
+    {
+        size_t end = min(text.find(',', start), text.size());
+        string_view entry = text.substr(start, end - start);
+        start = end + 1;
+
+        size_t equals = entry.find('=');
+        if (equals == string_view::npos)
+        {
+            return false;
+        }
+        int faculty = 0;
+        size_t places = 0;
+        auto category = from_chars(entry.data(), entry.data() + equals, faculty);
+        auto count = from_chars(entry.data() + equals + 1, entry.data() + entry.size(), places);
+        if (category.ec != errc() || category.ptr != entry.data() + equals || count.ec != errc() ||
+            count.ptr != entry.data() + entry.size() || faculty < 1 || faculty > faculty_count || places == 0)
+        {
+            return false;
+        }
+        quotas[faculty] = places;
+    }
+    return true;
+}
+
+int main(int argc, char **argv)
 {
+    int port = 8080;
+    ServerOptions options;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        string arg = argv[i];
+        if (arg == "--port" && i + 1 < argc)
+        {
+            port = atoi(argv[++i]);
+        }
+        else if (arg == "--backlog" && i + 1 < argc)
+        {
+            options.listen_backlog = max(1, atoi(argv[++i]));
+        }
+        else if (arg == "--max-header-bytes" && i + 1 < argc)
+        {
+            options.max_header_bytes = static_cast<size_t>(max(1L, atol(argv[++i])));
+        }
+        else if (arg == "--max-body-bytes" && i + 1 < argc)
+        {
+            options.max_body_bytes = static_cast<size_t>(max(1L, atol(argv[++i])));
+        }
+        else if (arg == "--event-loops" && i + 1 < argc)
+        {
+            options.event_loops = static_cast<unsigned>(max(0, atoi(argv[++i])));
+        }
+        else if (arg == "--backend" && i + 1 < argc)
+        {
+            string backend = argv[++i];
+            if (backend != "epoll" && backend != "io_uring")
+            {
+                printUsage(argv[0]);
+                return 1;
+            }
+            options.backend = backend == "io_uring" ? NetworkBackend::IoUring : NetworkBackend::Epoll;
+        }
+        else if (arg == "--handoff-socket" && i + 1 < argc)
+        {
+            options.handoff_socket_path = argv[++i];
+        }
+        else if (arg == "--log-file" && i + 1 < argc)
+        {
+            options.log_path = argv[++i];
+        }
+        else if (arg == "--access-log-sample" && i + 1 < argc)
+        {
+            options.access_log_sample = static_cast<unsigned>(max(0, atoi(argv[++i])));
+        }
+        else if (arg == "--merit-list-size" && i + 1 < argc)
+        {
+            options.merit_list_size = static_cast<size_t>(max(1, atoi(argv[++i])));
+        }
+        else if (arg == "--cohort" && i + 1 < argc)
+        {
+            options.cohort_path = argv[++i];
+        }
+        else if (arg == "--max-merit-candidates" && i + 1 < argc)
+        {
+            options.max_merit_candidates = static_cast<size_t>(max(0L, atol(argv[++i])));
+        }
+        else if (arg == "--quotas" && i + 1 < argc)
+        {
+            if (!parseQuotas(argv[++i], options.quotas))
+            {
+                printUsage(argv[0]);
+                return 1;
+            }
+        }
+        else
+        {
+            printUsage(argv[0]);
+            return arg == "--help" || arg == "-h" ? 0 : 1;
+        }
+    }
+
     try
     {
         cout << "Starting LASU Screening HTTP Server..." << endl;
 
-        LASUHttpServer server(8080);
+        LASUHttpServer server(port, options);
+        signal_target = &server;
+        installSignalHandlers();
 
-        cout << "Server will start on port 8080" << endl;
+        cout << "Server will start on port " << port << endl;
         cout << "Press Ctrl+C to stop the server" << endl;
 
         server.start();
+        signal_target = nullptr;
     }
     catch (const exception &e)
     {
+        signal_target = nullptr;
         cerr << "Error: " << e.what() << endl;
         return 1;
     }
@@ -0,0 +1,829 @@
+#pragma once
+
+// LASU post-UTME screening rules: the subject catalog, each faculty's
+// required subjects and cutoff, WAEC grade points, and the scoring that
+// turns a JAMB score and WAEC grades into a final score and admission
+// status. Shared by the HTTP server and the offline tools.
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <iomanip>
+#include <initializer_list>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+// Subjects a faculty can require. They are interned first, so each value
+// is also the subject's SubjectId.
+enum class Subject : uint16_t
+{
+    Mathematics,
+    EnglishLanguage,
+    Physics,
+    Chemistry,
+    Biology,
+    Government,
+    LiteratureInEnglish,
+    Economics,
+    Commerce,
+    Geography,
+    Count
+};
+
+inline const char *const subject_names[] = {
+    "Mathematics", "English Language", "Physics", "Chemistry", "Biology",
+    "Government", "Literature in English", "Economics", "Commerce", "Geography"};
+static_assert(std::size(subject_names) == static_cast<size_t>(Subject::Count), "one name per subject");
+
+inline std::string_view subjectName(Subject subject)
+{
+    return subject_names[static_cast<size_t>(subject)];
+}
+
+// Everything scoring needs to know about a faculty, one cache line each.
+// Faculties are identified by their course category (1-11); entry 0
+// stands for an unknown category and scores with no required subjects.
+struct alignas(64) FacultyPolicy
+{
+    static const size_t max_required = 5;
+
+    const char *name;
+    double cutoff; // as published; ScreeningTable holds the one in force
+    Subject required[max_required];
+    uint8_t required_count;
+    uint8_t max_points;         // from required subjects alone, 8 each
+    bool counts_best_optional;  // four-subject faculties add their best optional
+};
+
+constexpr FacultyPolicy makeFacultyPolicy(const char *name, std::initializer_list<Subject> required, double cutoff)
+{
+    FacultyPolicy policy{name, cutoff, {}, 0, 0, false};
+    for (Subject subject : required)
+    {
+        policy.required[policy.required_count++] = subject;
+    }
+    // Unknown categories keep the four-subject scale the old code fell back to
+    policy.max_points = policy.required_count == 5 ? 40 : 32;
+    policy.counts_best_optional = policy.required_count != 5;
+    return policy;
+}
+
+inline constexpr FacultyPolicy faculty_policies[] = {
+    makeFacultyPolicy("", {}, 55.0),
+    makeFacultyPolicy("Science/Basic Sciences",
+                      {Subject::Mathematics, Subject::EnglishLanguage, Subject::Physics, Subject::Chemistry}, 60.0),
+    makeFacultyPolicy("Arts and Humanities",
+                      {Subject::EnglishLanguage, Subject::Government, Subject::LiteratureInEnglish, Subject::Mathematics}, 50.0),
+    makeFacultyPolicy("Management Sciences",
+                      {Subject::EnglishLanguage, Subject::Mathematics, Subject::Economics, Subject::Commerce}, 60.0),
+    makeFacultyPolicy("Engineering",
+                      {Subject::Mathematics, Subject::EnglishLanguage, Subject::Physics, Subject::Chemistry}, 65.0),
+    makeFacultyPolicy("Medicine and Surgery",
+                      {Subject::Mathematics, Subject::EnglishLanguage, Subject::Physics, Subject::Chemistry, Subject::Biology}, 75.0),
+    makeFacultyPolicy("Law",
+                      {Subject::EnglishLanguage, Subject::Mathematics, Subject::Government, Subject::LiteratureInEnglish}, 70.0),
+    makeFacultyPolicy("Education",
+                      {Subject::EnglishLanguage, Subject::Mathematics, Subject::Government, Subject::Economics}, 45.0),
+    makeFacultyPolicy("Agriculture",
+                      {Subject::Mathematics, Subject::EnglishLanguage, Subject::Chemistry, Subject::Biology}, 50.0),
+    makeFacultyPolicy("Environmental Sciences",
+                      {Subject::Mathematics, Subject::EnglishLanguage, Subject::Physics, Subject::Geography}, 55.0),
+    makeFacultyPolicy("Social Sciences",
+                      {Subject::EnglishLanguage, Subject::Mathematics, Subject::Government, Subject::Economics}, 58.0),
+    makeFacultyPolicy("Allied Medical Sciences",
+                      {Subject::EnglishLanguage, Subject::Mathematics, Subject::Physics, Subject::Chemistry, Subject::Biology}, 65.0),
+};
+static_assert(sizeof(FacultyPolicy) == 64, "one cache line per faculty");
+inline const int faculty_count = static_cast<int>(std::size(faculty_policies)) - 1;
+
+// Policy for a course category; anything out of range gets entry 0
+inline const FacultyPolicy &facultyPolicy(int course_category)
+{
+    return faculty_policies[course_category >= 1 && course_category <= faculty_count ? course_category : 0];
+}
+
+using SubjectId = uint16_t;
+
+enum class Grade : uint8_t
+{
+    A1,
+    B2,
+    B3,
+    C4,
+    C5,
+    C6,
+    D7,
+    E8,
+    F9,
+    None // not a WAEC grade, or no grade recorded
+};
+
+// "A1" .. "F9"; each digit belongs to exactly one letter
+inline Grade parseGrade(std::string_view text)
+{
+    static const char letters[] = "ABBCCCDEF";
+    if (text.size() != 2 || text[1] < '1' || text[1] > '9' || text[0] != letters[text[1] - '1'])
+    {
+        return Grade::None;
+    }
+    return static_cast<Grade>(text[1] - '1');
+}
+
+inline int gradePoints(Grade grade)
+{
+    return grade == Grade::None ? 0 : 8 - static_cast<int>(grade);
+}
+
+inline std::string_view gradeName(Grade grade)
+{
+    static const char names[][3] = {"A1", "B2", "B3", "C4", "C5", "C6", "D7", "E8", "F9"};
+    return grade == Grade::None ? std::string_view("N/A") : std::string_view(names[static_cast<int>(grade)], 2);
+}
+
+// Process-wide subject name -> 16-bit ID dictionary. Lookups are lock-free
+// (open addressing over atomic slots, published after the name is
+// stored); inserts take a mutex and are only for trusted input (the
+// catalog, cohort files), since every new name keeps its slot for good.
+// The catalog subjects come first so their IDs equal their Subject values. Once full, or for absurdly long names,
+// everything else maps to `unknown`, which is harmless: only catalog
+// subjects are ever required, and optional ones only count by grade.
+class SubjectDictionary
+{
+public:
+    static constexpr SubjectId unknown = 0xFFFF;
+    static const size_t capacity = 4096;
+    static const size_t max_name_bytes = 64;
+
+    static SubjectDictionary &global()
+    {
+        static SubjectDictionary dictionary;
+        return dictionary;
+    }
+
+    // ID for an interned name, `unknown` otherwise
+    SubjectId find(std::string_view name) const
+    {
+        for (size_t slot = hash(name) & slot_mask;; slot = (slot + 1) & slot_mask)
+        {
+            uint32_t entry = slots[slot].load(std::memory_order_acquire);
+            if (entry == 0)
+            {
+                return unknown;
+            }
+            if (names[entry - 1] == name)
+            {
+                return static_cast<SubjectId>(entry - 1);
+            }
+        }
+    }
+
+    SubjectId intern(std::string_view name)
+    {
+        SubjectId id = find(name);
+        if (id != unknown || name.size() > max_name_bytes)
+        {
+            return id;
+        }
+
+        std::lock_guard<std::mutex> lock(insert_mutex);
+        size_t slot = hash(name) & slot_mask;
+        for (uint32_t entry; (entry = slots[slot].load(std::memory_order_relaxed)) != 0; slot = (slot + 1) & slot_mask)
+        {
+            if (names[entry - 1] == name)
+            {
+                return static_cast<SubjectId>(entry - 1); // raced with another insert
+            }
+        }
+        size_t next = count.load(std::memory_order_relaxed);
+        if (next == capacity)
+        {
+            return unknown;
+        }
+        names[next] = std::string(name);
+        count.store(next + 1, std::memory_order_release);
+        slots[slot].store(static_cast<uint32_t>(next + 1), std::memory_order_release);
+        return static_cast<SubjectId>(next);
+    }
+
+    std::string_view name(SubjectId id) const
+    {
+        return id < count.load(std::memory_order_acquire) ? std::string_view(names[id]) : std::string_view("?");
+    }
+
+private:
+    // At most half full, so every probe sequence reaches an empty slot
+    static const size_t slot_mask = capacity * 2 - 1;
+
+    std::unique_ptr<std::atomic<uint32_t>[]> slots; // ID + 1, 0 when empty
+    std::unique_ptr<std::string[]> names;
+    std::atomic<size_t> count;
+    std::mutex insert_mutex;
+
+    SubjectDictionary() : slots(new std::atomic<uint32_t>[slot_mask + 1]), names(new std::string[capacity]), count(0)
+    {
+        for (size_t i = 0; i <= slot_mask; ++i)
+        {
+            slots[i].store(0, std::memory_order_relaxed);
+        }
+        for (const char *subject : subject_names)
+        {
+            intern(subject);
+        }
+    }
+
+    static size_t hash(std::string_view name)
+    {
+        uint64_t h = 14695981039346656037ull; // FNV-1a
+        for (unsigned char c : name)
+        {
+            h = (h ^ c) * 1099511628211ull;
+        }
+        return static_cast<size_t>(h ^ (h >> 32));
+    }
+};
+
+// One candidate's WAEC results as plain data: fixed size, no pointers, so
+// a record can be copied or stored as-is and scored without hashing or
+// allocating. Required grades keep the last grade given per subject;
+// optional ones keep the best grades if more arrive than fit.
+struct CandidateGrades
+{
+    static const size_t max_subjects = 16;
+
+    struct Entry
+    {
+        SubjectId subject;
+        Grade grade;
+    };
+
+    Entry required[max_subjects];
+    Entry optional[max_subjects];
+    uint8_t required_count = 0;
+    uint8_t optional_count = 0;
+
+    // Only catalog subjects can be required by a faculty, so those are the
+    // only ones kept; there are fewer of them than slots
+    void setRequired(SubjectId subject, Grade grade)
+    {
+        if (subject >= static_cast<SubjectId>(Subject::Count))
+        {
+            return;
+        }
+        for (size_t i = 0; i < required_count; ++i)
+        {
+            if (required[i].subject == subject)
+            {
+                required[i].grade = grade;
+                return;
+            }
+        }
+        required[required_count++] = {subject, grade};
+    }
+
+    void addOptional(SubjectId subject, Grade grade)
+    {
+        if (optional_count < max_subjects)
+        {
+            optional[optional_count++] = {subject, grade};
+            return;
+        }
+        // Full: replace the weakest grade if this one is better
+        Entry *weakest = std::max_element(optional, optional + max_subjects, [](const Entry &a, const Entry &b)
+                                     { return a.grade < b.grade; });
+        if (grade < weakest->grade)
+        {
+            *weakest = {subject, grade};
+        }
+    }
+
+    Grade requiredGrade(Subject subject) const
+    {
+        for (size_t i = 0; i < required_count; ++i)
+        {
+            if (required[i].subject == static_cast<SubjectId>(subject))
+            {
+                return required[i].grade;
+            }
+        }
+        return Grade::None;
+    }
+
+    // Best optional grade, None if there are no optional subjects
+    const Entry *bestOptional() const
+    {
+        const Entry *best = nullptr;
+        for (size_t i = 0; i < optional_count; ++i)
+        {
+            if (!best || optional[i].grade < best->grade)
+            {
+                best = &optional[i];
+            }
+        }
+        return best;
+    }
+};
+static_assert(std::is_trivially_copyable<CandidateGrades>::value && std::is_standard_layout<CandidateGrades>::value,
+              "CandidateGrades must stay plain data");
+
+inline int facultyId(const FacultyPolicy &policy)
+{
+    return static_cast<int>(&policy - faculty_policies);
+}
+
+enum class AdmissionStatus : uint8_t
+{
+    Excellent,
+    Good,
+    Fair,
+    Poor
+};
+
+// The coarser, faculty-independent band reported as "status"
+enum class StatusClass : uint8_t
+{
+    Excellent,
+    Good,
+    Fair,
+    Poor
+};
+
+inline std::string_view admissionStatusText(AdmissionStatus status)
+{
+    static const char *const texts[] = {
+        "EXCELLENT - High chance of admission!",
+        "GOOD - Moderate chance of admission",
+        "FAIR - Consider retaking JAMB or improving WAEC",
+        "POOR - Strong recommendation to retake JAMB"};
+    return texts[static_cast<int>(status)];
+}
+
+inline std::string_view statusClassName(StatusClass status)
+{
+    static const char *const names[] = {"excellent", "good", "fair", "poor"};
+    return names[static_cast<int>(status)];
+}
+
+// Final score, admission status and status class for every possible input:
+// JAMB 0-400, WAEC total 0-40 on either scale (32 or 40 points), every
+// faculty. Scores are shared by all faculties (263KB of doubles); the two
+// status bands are packed into one byte per faculty (394KB). Scoring a
+// candidate is two indexed loads instead of float math and threshold
+// chains. Every entry a faculty's subjects can reach is checked against
+// LASUScreeningAggregator::calculateUntabulated, the scoring as first
+// written, when the faculty's bands are built.
+//
+// A faculty's cutoff can be changed while the table is in use (e.g. from
+// admission quotas): its bands are rebuilt and checked aside, then
+// published with one pointer swap. Replaced bands are kept, since a
+// reader may still be using them; 33KB per change.
+class ScreeningTable
+{
+public:
+    struct Outcome
+    {
+        double final_score = 0.0;
+        AdmissionStatus admission = AdmissionStatus::Poor;
+        StatusClass status = StatusClass::Poor;
+    };
+
+    static const int max_jamb = 400;
+    static const int max_waec = 40;
+
+    // A faculty's cutoff with the status bands judged against it, published
+    // together so readers never see one without the other
+    struct Bands
+    {
+        double cutoff;
+        std::vector<uint8_t> packed; // admission status << 4 | status class
+    };
+
+    // Throws runtime_error if any entry disagrees with the aggregator
+    static ScreeningTable &global()
+    {
+        static ScreeningTable table;
+        return table;
+    }
+
+    // The faculty's current bands; stays valid for the table's lifetime
+    const Bands &bands(int faculty) const
+    {
+        return *faculty_bands[faculty].load(std::memory_order_acquire);
+    }
+
+    // jamb_score 0-400, waec_total 0-40, waec_max_points 32 or 40
+    Outcome lookup(const Bands &published, int jamb_score, int waec_total, int waec_max_points) const
+    {
+        size_t index = scoreIndex(jamb_score, waec_total, waec_max_points);
+        uint8_t packed = published.packed[index];
+        return {scores[index], static_cast<AdmissionStatus>(packed >> 4), static_cast<StatusClass>(packed & 15)};
+    }
+
+    Outcome lookup(int faculty, int jamb_score, int waec_total, int waec_max_points) const
+    {
+        return lookup(bands(faculty), jamb_score, waec_total, waec_max_points);
+    }
+
+    // The cutoff admission status is currently judged against
+    double cutoff(int faculty) const
+    {
+        return bands(faculty).cutoff;
+    }
+
+    // Judges the faculty's admission status against `cutoff` from now on,
+    // with the usual bands 10 points either side. Throws runtime_error
+    // (and changes nothing) if the new bands disagree with the aggregator.
+    void setCutoff(int faculty, double new_cutoff)
+    {
+        std::lock_guard<std::mutex> lock(update_mutex);
+        faculty_bands[faculty].store(buildBands(faculty, new_cutoff), std::memory_order_release);
+    }
+
+private:
+    static const size_t score_entries = 2 * (max_waec + 1) * (max_jamb + 1);
+
+    std::vector<double> scores;
+    std::deque<Bands> band_slices; // every set published, since readers may hold any of them
+    std::atomic<const Bands *> faculty_bands[std::size(faculty_policies)];
+    std::mutex update_mutex;
+
+    static size_t scoreIndex(int jamb_score, int waec_total, int waec_max_points)
+    {
+        size_t scale = waec_max_points == 40 ? 1 : 0;
+        return (scale * (max_waec + 1) + static_cast<size_t>(waec_total)) * (max_jamb + 1) +
+               static_cast<size_t>(jamb_score);
+    }
+
+    ScreeningTable() : scores(score_entries)
+    {
+        // Each share is rounded to a double on its own before the sum, as
+        // the aggregator's members are; one expression could be contracted
+        // into an FMA and differ in the last bit
+        double jamb_share[max_jamb + 1];
+        for (int jamb = 0; jamb <= max_jamb; ++jamb)
+        {
+            jamb_share[jamb] = (jamb / 400.0) * 60.0;
+        }
+        for (int scale : {32, 40})
+        {
+            double waec_share[max_waec + 1];
+            for (int total = 0; total <= max_waec; ++total)
+            {
+                waec_share[total] = (total / (double)scale) * 40.0;
+            }
+            for (int total = 0; total <= max_waec; ++total)
+            {
+                for (int jamb = 0; jamb <= max_jamb; ++jamb)
+                {
+                    scores[scoreIndex(jamb, total, scale)] = jamb_share[jamb] + waec_share[total];
+                }
+            }
+        }
+        for (int faculty = 0; faculty <= faculty_count; ++faculty)
+        {
+            faculty_bands[faculty].store(buildBands(faculty, faculty_policies[faculty].cutoff),
+                                         std::memory_order_relaxed);
+        }
+    }
+
+    // Bands for every score against `cutoff`, checked before they are
+    // returned for publishing
+    const Bands *buildBands(int faculty, double cutoff)
+    {
+        std::vector<uint8_t> bands(score_entries);
+        double excellent_from = cutoff + 10;
+        double fair_from = cutoff - 10;
+        for (size_t index = 0; index < score_entries; ++index)
+        {
+            double score = scores[index];
+            uint8_t status = score >= 70.0 ? 0 : score >= 60.0 ? 1 : score >= 50.0 ? 2 : 3;
+            uint8_t admission = score >= excellent_from ? 0
+                                : score >= cutoff       ? 1
+                                : score >= fair_from    ? 2
+                                                        : 3;
+            bands[index] = static_cast<uint8_t>(admission << 4 | status);
+        }
+        verify(faculty, cutoff, bands.data());
+        band_slices.push_back({cutoff, std::move(bands)});
+        return &band_slices.back();
+    }
+
+    // Runs a LASUScreeningAggregator through every JAMB score and every
+    // WAEC total the faculty's subjects can produce, and throws
+    // runtime_error at the first entry that disagrees with it. Defined
+    // after the aggregator.
+    void verify(int faculty, double cutoff, const uint8_t *bands) const;
+};
+
+
+class JAMBAllocation {
+private:
+    int jambScore;
+    double jambPercentage;
+    
+public:
+    JAMBAllocation() : jambScore(0), jambPercentage(0.0) {}
+    
+    // False (and the score left unchanged) unless it is within 0-400
+    bool setJambScore(int score) {
+        if (score < 0 || score > 400) {
+            return false;
+        }
+        jambScore = score;
+        calculateJambPercentage();
+        return true;
+    }
+    
+    void calculateJambPercentage() {
+        jambPercentage = (jambScore / 400.0) * 60.0; // 60% for JAMB
+    }
+    
+    // Getters
+    int getJambScore() const { return jambScore; }
+    double getJambPercentage() const { return jambPercentage; }
+    
+    void displayJambResults() const {
+        std::cout << "\nJAMB SECTION (60% Weight):\n";
+        std::cout << "JAMB Score: " << jambScore << "/400\n";
+        std::cout << "JAMB Percentage: " << std::fixed << std::setprecision(1) << jambPercentage << "%\n";
+    }
+};
+
+// Grades live in a fixed-size CandidateGrades record, so scoring neither
+// hashes nor allocates. Nothing here prints while scoring: setters report
+// rejected input through their return values and the caller decides what
+// to log.
+class WAECAllocation {
+private:
+    CandidateGrades grades;
+    const FacultyPolicy* policy;
+    int requiredPoints[FacultyPolicy::max_required]; // parallel to policy->required
+    double waecPercentage;
+    int totalScore;
+    int maxPoints; // 32, or 40 with five subjects counted
+    uint8_t missingMask; // bit i: policy->required[i] had no grade
+    
+public:
+    WAECAllocation()
+        : grades(), policy(&facultyPolicy(0)), requiredPoints(), waecPercentage(0.0), totalScore(0),
+          maxPoints(32), missingMask(0) {}
+    
+    // False (and no required subjects) for an unknown faculty
+    bool setRequiredSubjects(int choice) {
+        policy = &facultyPolicy(choice);
+        return policy->required_count > 0;
+    }
+    
+    // Both return false, keeping nothing, for a grade that is not A1-F9
+    bool addGrade(std::string_view subject, std::string_view grade) {
+        Grade parsed = parseGrade(grade);
+        if (parsed == Grade::None) {
+            return false;
+        }
+        grades.setRequired(SubjectDictionary::global().find(subject), parsed);
+        return true;
+    }
+    
+    // Names come from clients, so they are looked up, never interned: an
+    // unlisted one counts by its grade as `unknown`
+    bool addOptionalSubject(std::string_view subject, std::string_view grade) {
+        Grade parsed = parseGrade(grade);
+        if (parsed == Grade::None) {
+            return false;
+        }
+        grades.addOptional(SubjectDictionary::global().find(subject), parsed);
+        return true;
+    }
+    
+    int getGradePoint(std::string_view grade) const {
+        return gradePoints(parseGrade(grade));
+    }
+    
+    void calculateWaecAllocation() {
+        // Process required subjects
+        totalScore = 0;
+        missingMask = 0;
+        for (size_t i = 0; i < policy->required_count; ++i) {
+            Grade grade = grades.requiredGrade(policy->required[i]);
+            if (grade == Grade::None) {
+                missingMask |= static_cast<uint8_t>(1u << i);
+            }
+            requiredPoints[i] = gradePoints(grade);
+            totalScore += requiredPoints[i];
+        }
+        
+        // Faculties with four required subjects also count the best optional one
+        maxPoints = policy->max_points;
+        if (policy->counts_best_optional && grades.optional_count > 0) {
+            totalScore += gradePoints(grades.bestOptional()->grade);
+            maxPoints += 8; // 5 subjects total
+        }
+        
+        // Calculate percentage (40% weight for WAEC)
+        waecPercentage = (totalScore / (double)maxPoints) * 40.0;
+    }
+    
+    void displayResults() const {
+        std::cout << "\nWAEC SECTION (40% Weight) - " << policy->name << ":\n";
+        std::cout << "=========================\n";
+        
+        std::cout << "\nRequired Subjects:\n";
+        std::cout << "------------------\n";
+        for (size_t i = 0; i < policy->required_count; ++i) {
+            Subject subject = policy->required[i];
+            std::cout << subjectName(subject) << ": " << gradeName(grades.requiredGrade(subject))
+                 << " (" << requiredPoints[i] << " points)\n";
+        }
+        
+        // Show optional subjects only if the faculty counts one
+        if (policy->counts_best_optional) {
+            std::cout << "\nOptional Subjects (Best Selected):\n";
+            std::cout << "----------------------------------\n";
+            const CandidateGrades::Entry* best = grades.bestOptional();
+            if (best && gradePoints(best->grade) > 0) {
+                std::cout << SubjectDictionary::global().name(best->subject) << ": " << gradeName(best->grade)
+                     << " (" << gradePoints(best->grade) << " points)\n";
+            } else if (!best) {
+                std::cout << "No optional subjects provided.\n";
+            }
+        }
+        
+        std::cout << "\nTotal Score: " << totalScore << "/" << 40 << "\n";
+        std::cout << "WAEC Percentage: " << std::fixed << std::setprecision(1) << waecPercentage << "%\n";
+    }
+    
+    // Getters
+    double getPercentage() const { return waecPercentage; }
+    int getTotalScore() const { return totalScore; }
+    int getMaxPoints() const { return maxPoints; }
+    std::string_view getFacultyName() const { return policy->name; }
+    const FacultyPolicy& getFacultyPolicy() const { return *policy; }
+    const CandidateGrades& getGrades() const { return grades; }
+    
+    // Whether the last calculation found no grade for policy.required[index]
+    bool isRequiredSubjectMissing(size_t index) const {
+        return (missingMask >> index) & 1u;
+    }
+};
+
+class LASUScreeningAggregator : public JAMBAllocation, public WAECAllocation {
+private:
+    double finalScreeningScore;
+    ScreeningTable::Outcome outcome;
+    
+public:
+    LASUScreeningAggregator() : finalScreeningScore(0.0) {}
+    
+    void calculateScreeningResults() {
+        // Calculate WAEC allocation
+        calculateWaecAllocation();
+        
+        // Final score and both status bands come precomputed
+        outcome = ScreeningTable::global().lookup(facultyId(getFacultyPolicy()), getJambScore(),
+                                                  getTotalScore(), getMaxPoints());
+        finalScreeningScore = outcome.final_score;
+        
+        // cout << "\nCalculation Breakdown:\n";
+        // cout << "======================\n";
+        // cout << "JAMB Score: " << getJambScore() << "/400 = " 
+        //      << fixed << setprecision(1) << getJambPercentage() << "%\n";
+        // cout << "WAEC Score: " << getTotalScore() << "/40 = " 
+        //      << fixed << setprecision(1) << getPercentage() << "%\n";
+        // cout << "Final Aggregate: " << getJambPercentage() << "% + " 
+        //      << getPercentage() << "% = " << finalScreeningScore << "%\n";
+    }
+
+    // The scoring as first written, with no table: the arithmetic of
+    // JAMBAllocation and WAECAllocation, then the threshold chains.
+    // ScreeningTable is checked against this; nothing else needs it.
+    ScreeningTable::Outcome calculateUntabulated(double cutoffThreshold) {
+        calculateWaecAllocation();
+        ScreeningTable::Outcome result;
+        result.final_score = getJambPercentage() + getPercentage();
+        
+        if (result.final_score >= cutoffThreshold + 10) {
+            result.admission = AdmissionStatus::Excellent;
+        } else if (result.final_score >= cutoffThreshold) {
+            result.admission = AdmissionStatus::Good;
+        } else if (result.final_score >= cutoffThreshold - 10) {
+            result.admission = AdmissionStatus::Fair;
+        } else {
+            result.admission = AdmissionStatus::Poor;
+        }
+        
+        if (result.final_score >= 70.0) {
+            result.status = StatusClass::Excellent;
+        } else if (result.final_score >= 60.0) {
+            result.status = StatusClass::Good;
+        } else if (result.final_score >= 50.0) {
+            result.status = StatusClass::Fair;
+        } else {
+            result.status = StatusClass::Poor;
+        }
+        return result;
+    }
+
+    double getFinalScreeningScore()
+    {
+        return finalScreeningScore;
+    }
+    
+    std::string_view getAdmissionStatus() const {
+        // cout << "\n========================================\n";
+        // cout << "      LASU SCREENING RESULTS\n";
+        // cout << "========================================\n";
+        
+        // // Display JAMB results
+        // displayJambResults();
+        
+        // // Display WAEC results
+        // displayResults();
+        
+        // // Display final aggregate
+        // cout << "\n========================================\n";
+        // cout << "FINAL SCREENING AGGREGATE - " << getFacultyName() << ":\n";
+        // cout << "========================================\n";
+        // cout << "JAMB Contribution: " << fixed << setprecision(1) << getJambPercentage() << "%\n";
+        // cout << "WAEC Contribution: " << fixed << setprecision(1) << getPercentage() << "%\n";
+        // cout << "TOTAL SCREENING SCORE: " << finalScreeningScore << "%\n";
+        
+
+        // Faculty-specific admission guidance
+        // cout << "\nADMISSION PROSPECT FOR " << getFacultyName() << ":\n";
+        return admissionStatusText(outcome.admission);
+        
+        // cout << "Estimated Cut-off for " << getFacultyName() << ": " << cutoffThreshold << "%\n";
+        // cout << "========================================\n";
+    }
+
+    
+    // "excellent", "good", "fair" or "poor", whatever the faculty
+    std::string_view getStatusClass() const {
+        return statusClassName(outcome.status);
+    }
+    
+    double getCutoffThreshold() const {
+        // Published per faculty, or set from admission quotas
+        return ScreeningTable::global().cutoff(facultyId(getFacultyPolicy()));
+    }
+    
+    double getFinalScreeningScore() const {
+        return finalScreeningScore;
+    }
+};
+
+inline void ScreeningTable::verify(int faculty, double cutoff, const uint8_t *bands) const
+{
+    // Grade names by points: F9 is worth 0, A1 8
+    static const char *const grade_for_points[] = {"F9", "E8", "D7", "C6", "C5", "C4", "B3", "B2", "A1"};
+    const FacultyPolicy &policy = faculty_policies[faculty];
+
+    for (bool with_optional : {false, true})
+    {
+        if (with_optional && !policy.counts_best_optional)
+        {
+            continue;
+        }
+        int subjects = policy.required_count + (with_optional ? 1 : 0);
+        for (int total = 0; total <= 8 * subjects; ++total)
+        {
+            // Fill the subjects in order, 8 points each until `total` is spent
+            LASUScreeningAggregator calculator;
+            calculator.setRequiredSubjects(faculty);
+            int left = total;
+            for (size_t i = 0; i < policy.required_count; ++i)
+            {
+                int points = std::min(left, 8);
+                left -= points;
+                calculator.addGrade(subjectName(policy.required[i]), grade_for_points[points]);
+            }
+            if (with_optional)
+            {
+                calculator.addOptionalSubject("Further Mathematics", grade_for_points[left]);
+            }
+
+            for (int jamb = 0; jamb <= max_jamb; ++jamb)
+            {
+                calculator.setJambScore(jamb);
+                Outcome expected = calculator.calculateUntabulated(cutoff);
+                size_t index = scoreIndex(jamb, calculator.getTotalScore(), calculator.getMaxPoints());
+                if (scores[index] != expected.final_score ||
+                    static_cast<AdmissionStatus>(bands[index] >> 4) != expected.admission ||
+                    static_cast<StatusClass>(bands[index] & 15) != expected.status)
+                {
+                    throw std::runtime_error("Score table disagrees with the aggregator at faculty " +
+                                             std::to_string(faculty) + ", JAMB " + std::to_string(jamb) +
+                                             ", WAEC " + std::to_string(calculator.getTotalScore()) + "/" +
+                                             std::to_string(calculator.getMaxPoints()));
+                }
+            }
+        }
+    }
+}